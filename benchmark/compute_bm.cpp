@@ -60,6 +60,32 @@ void SingleComputation(benchmark::State& state)
   }
 }
 
+// Evaluates a polynomial by the Horner scheme, i.e. every element is a long chain of dependent multiply-adds, whose
+// latency is hidden by unrolling.
+template<int Unroll>
+void PolynomialLoop(benchmark::State& state)
+{
+  constexpr int vec_size = stdx::native_simd<double>::size();
+  auto arraySize = state.range(0);
+  std::vector<double> x(arraySize, 0.5), y(arraySize);
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(x.data());
+    sa::loop<vec_size>(0, arraySize, [&](auto i)
+      {
+        auto xi = SIMD_ACCESS_V(x, i);
+        auto result = xi * 0.1 + 0.2;
+        for (int k = 0; k < 64; ++k)
+        {
+          result = result * xi + 0.3;
+        }
+        SIMD_ACCESS(y, i) = result;
+      }, sa::ScalarResidualLoop, sa::Unroll<Unroll>);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(arraySize * state.iterations());
+}
+
 
 BENCHMARK_TEMPLATE(HeatCPUAndStack, double);
 BENCHMARK_TEMPLATE(HeatCPUAndStack, fixed_simd<double>);
@@ -69,3 +95,5 @@ BENCHMARK_TEMPLATE(SingleComputation, double, Operation::Mul);
 BENCHMARK_TEMPLATE(SingleComputation, fixed_simd<double>, Operation::Mul);
 BENCHMARK_TEMPLATE(SingleComputation, double, Operation::Div);
 BENCHMARK_TEMPLATE(SingleComputation, fixed_simd<double>, Operation::Div);
+BENCHMARK_TEMPLATE(PolynomialLoop, 1)->Arg(4000);
+BENCHMARK_TEMPLATE(PolynomialLoop, 4)->Arg(4000);
@@ -0,0 +1,115 @@
+
+#include "benchmark/benchmark.h"
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/aosoa_vector.hpp"
+#include "simd_access/soa_vector.hpp"
+
+namespace {
+
+template<class T, int MemberCount>
+struct Record
+{
+  T m[MemberCount];
+};
+
+template<int SimdSize, class T, int MemberCount>
+inline auto simdized_value(const Record<T, MemberCount>& r)
+{
+  using simd_access::simdized_value;
+  return Record<decltype(simdized_value<SimdSize>(r.m[0])), MemberCount>();
+}
+
+template<class DestType, class SrcType, int MemberCount, class FN>
+inline void simd_members(Record<DestType, MemberCount>& d, const Record<SrcType, MemberCount>& s, FN&& func)
+{
+  using simd_access::simd_members;
+  for (int k = 0; k < MemberCount; ++k)
+  {
+    simd_members(d.m[k], s.m[k], func);
+  }
+}
+
+constexpr int vec_size = stdx::native_simd<double>::size();
+
+template<int MemberCount>
+using AoS = std::vector<Record<double, MemberCount>>;
+
+template<int MemberCount>
+using SoA = simd_access::soa_vector<Record<double, MemberCount>>;
+
+template<int MemberCount>
+using AoSoA = simd_access::aosoa_vector<Record<double, MemberCount>, 2 * vec_size>;
+
+template<class Container, int MemberCount>
+Container MakeRecords(size_t size)
+{
+  Container records(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    for (int k = 0; k < MemberCount; ++k)
+    {
+      SIMD_ACCESS(records, i, .m[k]) = double(i + k);
+    }
+  }
+  return records;
+}
+
+}
+
+// Loads whole records, i.e. all members are touched.
+template<template<int> class Container, int MemberCount>
+void Layout_RecordRead(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  auto records = MakeRecords<Container<MemberCount>, MemberCount>(arraySize);
+  std::vector<double> result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, arraySize, [&](auto i)
+      {
+        auto r = SIMD_ACCESS_V(records, i);
+        auto sum = r.m[0];
+        for (int k = 1; k < MemberCount; ++k)
+        {
+          sum += r.m[k];
+        }
+        SIMD_ACCESS(result, i) = sum;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * ((MemberCount + 1) * sizeof(double)) * state.iterations());
+}
+
+// Updates a single member of the records.
+template<template<int> class Container, int MemberCount>
+void Layout_MemberUpdate(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  auto records = MakeRecords<Container<MemberCount>, MemberCount>(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, arraySize, [&](auto i)
+      {
+        SIMD_ACCESS(records, i, .m[0]) += 1.0;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (2 * sizeof(double)) * state.iterations());
+}
+
+#define BM_LAYOUT( name, layout, member_count ) \
+  BENCHMARK_TEMPLATE( name, layout, member_count )->Unit(benchmark::kMicrosecond)->Arg(4000)->Arg(1 << 20)
+
+#define BM_LAYOUTS( name, member_count ) \
+  BM_LAYOUT( name, AoS, member_count ); \
+  BM_LAYOUT( name, SoA, member_count ); \
+  BM_LAYOUT( name, AoSoA, member_count )
+
+BM_LAYOUTS(Layout_RecordRead, 2);
+BM_LAYOUTS(Layout_RecordRead, 4);
+BM_LAYOUTS(Layout_RecordRead, 8);
+BM_LAYOUTS(Layout_MemberUpdate, 2);
+BM_LAYOUTS(Layout_MemberUpdate, 4);
+BM_LAYOUTS(Layout_MemberUpdate, 8);
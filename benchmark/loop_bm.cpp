@@ -1,11 +1,19 @@
 
 #include "benchmark/benchmark.h"
 #include <experimental/bits/simd.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
 #include <vector>
 #include <iostream>
 
 #include "simd_access/simd_access.hpp"
+#include "simd_access/bit_view.hpp"
+#include "simd_access/quantized_view.hpp"
+#include "simd_access/row_major_view.hpp"
 #include "simd_access/simd_loop.hpp"
+#include "simd_access/stencil_loop.hpp"
 
 template<class T>
 void HeatCache(const std::vector<T>& testData)
@@ -93,6 +101,50 @@ void Loop_ScatteredSimdReadAccess(benchmark::State& state)
   state.SetBytesProcessed(arraySize * (sizeof(double)) * state.iterations());
 }
 
+void Loop_IndirectSimdReadAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<int> indices(arraySize);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937(1));
+  HeatCache(testData);
+  auto dataPtr = testData.data();
+  for (auto _ : state)
+  {
+    simd_access::loop_with_linear_index<vec_size>(indices.begin(), indices.end(), [&](auto, auto i)
+      {
+        auto result = SIMD_ACCESS_V(dataPtr, i);
+        benchmark::DoNotOptimize(result);
+      });
+  }
+  state.SetBytesProcessed(arraySize * (sizeof(double)) * state.iterations());
+}
+
+void Loop_IndirectSimdReadAccessPrefetch(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<int> indices(arraySize);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937(1));
+  HeatCache(testData);
+  auto dataPtr = testData.data();
+  for (auto _ : state)
+  {
+    simd_access::loop_with_linear_index<vec_size>(indices.begin(), indices.end(), [&](auto, auto i)
+      {
+        auto result = SIMD_ACCESS_V(dataPtr, i);
+        benchmark::DoNotOptimize(result);
+      }, simd_access::ScalarResidualLoop, simd_access::prefetch<2>(8, dataPtr));
+  }
+  state.SetBytesProcessed(arraySize * (sizeof(double)) * state.iterations());
+}
+
 void Loop_LinearSimdReadAccess(benchmark::State& state)
 {
   auto arraySize = state.range(0);
@@ -152,10 +204,364 @@ void Loop_LinearScalarReadAccess(benchmark::State& state)
   state.SetBytesProcessed(arraySize * (sizeof(double)) * state.iterations());
 }
 
+void Loop_LinearSimdWriteAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<double> result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, testData.size(), [&](auto i)
+      {
+        SIMD_ACCESS(result, i) = SIMD_ACCESS_V(testData, i) * 2.0;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (2 * sizeof(double)) * state.iterations());
+}
+
+void Loop_LinearSimdStreamingWriteAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<double> result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, testData.size(), [&](auto i)
+      {
+        SIMD_ACCESS(result, i) = SIMD_ACCESS_V(testData, i) * 2.0;
+      }, simd_access::ScalarResidualLoop, simd_access::streaming_store(result));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (2 * sizeof(double)) * state.iterations());
+}
+
+// axpy computed in double on arrays stored as StorageType, e.g. float or half precision bit patterns
+template<class StorageType, class Encoding>
+void Loop_MixedPrecisionUpdate(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<StorageType> x(arraySize), y(arraySize);
+  for (int64_t i = 0; i < arraySize; ++i)
+  {
+    simd_access::as<double, Encoding>(x[i]) = double(i % 1000);
+    simd_access::as<double, Encoding>(y[i]) = 1.0;
+  }
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, x.size(), [&](auto i)
+      {
+        simd_access::as<double, Encoding>(SIMD_ACCESS(x, i)) =
+          simd_access::to_simd(simd_access::as<double, Encoding>(SIMD_ACCESS(x, i))) * 0.5 +
+          simd_access::to_simd(simd_access::as<double, Encoding>(SIMD_ACCESS(y, i)));
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (3 * sizeof(StorageType)) * state.iterations());
+}
+
+// scaled sensor samples, which are quantized to 16 bits, dequantized into a temporary array in a separate pass
+void Loop_QuantizedCopyAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  std::vector<std::int16_t> samples(arraySize);
+  GenerateNWithIndex(samples.begin(), arraySize, [](auto i) { return std::int16_t(i % 30000); });
+  std::vector<float> dequantized(arraySize), result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, samples.size(), [&](auto i)
+      {
+        SIMD_ACCESS(dequantized, i) = simd_access::to_simd(simd_access::as<float>(SIMD_ACCESS(samples, i))) * 0.01f;
+      });
+    simd_access::loop<vec_size>(0, samples.size(), [&](auto i)
+      {
+        SIMD_ACCESS(result, i) = SIMD_ACCESS_V(dequantized, i) * 2.0f;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (sizeof(std::int16_t) + sizeof(float)) * state.iterations());
+}
+
+// the same samples dequantized as part of the loads
+void Loop_QuantizedViewAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  std::vector<std::int16_t> samples(arraySize);
+  GenerateNWithIndex(samples.begin(), arraySize, [](auto i) { return std::int16_t(i % 30000); });
+  std::vector<float> result(arraySize);
+  auto view = simd_access::make_quantized_view(samples.data(), samples.size(), 0.01f);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, samples.size(), [&](auto i)
+      {
+        SIMD_ACCESS(result, i) = SIMD_ACCESS_V(view, i) * 2.0f;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (sizeof(std::int16_t) + sizeof(float)) * state.iterations());
+}
+
+// update of the active cells, whose flags are stored in bytes
+void Loop_ByteMaskAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  std::vector<std::uint8_t> active(arraySize);
+  GenerateNWithIndex(active.begin(), arraySize, [](auto i) { return std::uint8_t(i % 7 < 4); });
+  std::vector<float> x(arraySize, 1.0f);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, x.size(), [&](auto i)
+      {
+        where(SIMD_ACCESS_V(active, i) != 0, SIMD_ACCESS(x, i)) = SIMD_ACCESS_V(x, i) * 0.5f;
+      }, simd_access::MaskedResidualLoop);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (sizeof(std::uint8_t) + 2 * sizeof(float)) * state.iterations());
+}
+
+// update of the active cells, whose flags are stored in bits
+void Loop_BitMaskAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  std::vector<std::uint64_t> words(simd_access::bit_view<>::word_count(arraySize));
+  auto active = simd_access::make_bit_view(words.data(), arraySize);
+  for (int64_t i = 0; i < arraySize; ++i)
+  {
+    active[i] = i % 7 < 4;
+  }
+  std::vector<float> x(arraySize, 1.0f);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(0, x.size(), [&](auto i)
+      {
+        where(SIMD_ACCESS_V(active, i), SIMD_ACCESS(x, i)) = SIMD_ACCESS_V(x, i) * 0.5f;
+      }, simd_access::MaskedResidualLoop);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * 2 * sizeof(float) * state.iterations());
+}
+
+// weighted sum of the neighbours i - Radius, ..., i + Radius
+template<int Radius>
+auto StencilSum(auto&& neighbour)
+{
+  return [&]<int... Offset>(std::integer_sequence<int, Offset...>)
+    {
+      return ((double(Radius + 1 - std::abs(Offset - Radius)) * neighbour(Offset - Radius)) + ...);
+    } (std::make_integer_sequence<int, 2 * Radius + 1>());
+}
+
+template<int Radius>
+void Loop_StencilReloadAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<double> result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(Radius, testData.size() - Radius, [&](auto i)
+      {
+        SIMD_ACCESS(result, i) = StencilSum<Radius>([&](int k) { return SIMD_ACCESS_V(testData, i + k); });
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (2 * sizeof(double)) * state.iterations());
+}
+
+template<int Radius>
+void Loop_StencilShiftedAccess(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  std::vector<double> result(arraySize);
+  for (auto _ : state)
+  {
+    simd_access::stencil_loop<vec_size, Radius>(Radius, testData.size() - Radius, testData,
+      [&](auto i, const auto& window)
+      {
+        SIMD_ACCESS(result, i) = StencilSum<Radius>([&](int k) { return window[k]; });
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(arraySize * (2 * sizeof(double)) * state.iterations());
+}
+
+// scales column 1 of a row-major matrix with `Cols` columns
+template<size_t Cols>
+void Loop_ColumnIndexArrayAccess(benchmark::State& state)
+{
+  auto rows = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> matrix(rows * Cols);
+  GenerateNWithIndex(matrix.begin(), matrix.size(), [](auto i) { return double(i + 1); });
+  std::vector<size_t> indices(rows);
+  GenerateNWithIndex(indices.begin(), rows, [](auto i) { return i * Cols + 1; });
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(indices.begin(), indices.end(), [&](auto i)
+      {
+        SIMD_ACCESS(matrix, i) = SIMD_ACCESS_V(matrix, i) * 1.5;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(rows * (2 * sizeof(double)) * state.iterations());
+}
+
+template<size_t Cols>
+void Loop_ColumnStridedAccess(benchmark::State& state)
+{
+  auto rows = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> matrix(rows * Cols);
+  GenerateNWithIndex(matrix.begin(), matrix.size(), [](auto i) { return double(i + 1); });
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(size_t(1), matrix.size(), [&](auto i)
+      {
+        SIMD_ACCESS(matrix, i) = SIMD_ACCESS_V(matrix, i) * 1.5;
+      }, simd_access::ScalarResidualLoop, simd_access::Stride<Cols>);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(rows * (2 * sizeof(double)) * state.iterations());
+}
+
+template<size_t Cols>
+void Loop_ColumnRuntimeStridedAccess(benchmark::State& state)
+{
+  auto rows = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> matrix(rows * Cols);
+  GenerateNWithIndex(matrix.begin(), matrix.size(), [](auto i) { return double(i + 1); });
+  for (auto _ : state)
+  {
+    simd_access::loop<vec_size>(size_t(1), matrix.size(), [&](auto i)
+      {
+        SIMD_ACCESS(matrix, i) = SIMD_ACCESS_V(matrix, i) * 1.5;
+      }, simd_access::ScalarResidualLoop, simd_access::stride(Cols));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(rows * (2 * sizeof(double)) * state.iterations());
+}
+
+template<int AccumulatorCount>
+void Loop_LinearSimdReduce(benchmark::State& state)
+{
+  auto arraySize = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(arraySize);
+  GenerateNWithIndex(testData.begin(), arraySize, [](auto i) { return double(i + 1); });
+  HeatCache(testData);
+  for (auto _ : state)
+  {
+    auto result = simd_access::loop_reduce<vec_size, AccumulatorCount>(0, testData.size(), 0.0, [&](auto i)
+      {
+        return SIMD_ACCESS(testData, i);
+      }, std::plus<>());
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(arraySize * sizeof(double) * state.iterations());
+}
+
+// Writes a cubic grid of `edge^3` elements by loops over the rows.
+void Loop_GridNestedWriteAccess(benchmark::State& state)
+{
+  size_t edge = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(edge * edge * edge, 1.0), result(edge * edge * edge);
+  for (auto _ : state)
+  {
+    for (size_t k = 0; k < edge; ++k)
+    {
+      for (size_t j = 0; j < edge; ++j)
+      {
+        const double* src_row = &testData[(k * edge + j) * edge];
+        double* dest_row = &result[(k * edge + j) * edge];
+        simd_access::loop<vec_size>(0, edge, [&](auto i)
+          {
+            SIMD_ACCESS(dest_row, i) = SIMD_ACCESS_V(src_row, i) * 2.0;
+          });
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(edge * edge * edge * (2 * sizeof(double)) * state.iterations());
+}
+
+// Writes a cubic grid of `edge^3` elements by a multi-dimensional loop.
+void Loop_GridNdWriteAccess(benchmark::State& state)
+{
+  size_t edge = state.range(0);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<double> testData(edge * edge * edge, 1.0), result(edge * edge * edge);
+  auto src = simd_access::make_row_major_view(testData.data(), edge, edge, edge);
+  auto dest = simd_access::make_row_major_view(result.data(), edge, edge, edge);
+  for (auto _ : state)
+  {
+    simd_access::loop_nd<vec_size>(std::array<size_t, 3>{}, std::array{ edge, edge, edge }, [&](auto i)
+      {
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) * 2.0;
+      });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(edge * edge * edge * (2 * sizeof(double)) * state.iterations());
+}
+
 #define BM_READ( name ) BENCHMARK( name )->Unit(benchmark::kMicrosecond)->Arg(100)->Arg(4000)
 
 BM_READ(Loop_IntrinsicScatteredSimdReadAccess);
 BM_READ(Loop_ScatteredSimdReadAccess);
+BM_READ(Loop_IndirectSimdReadAccess);
+BM_READ(Loop_IndirectSimdReadAccessPrefetch);
 BM_READ(Loop_LinearSimdReadAccess);
 BM_READ(Loop_LinearInlinedSimdReadAccess);
 BM_READ(Loop_LinearScalarReadAccess);
+BM_READ(Loop_LinearSimdReduce<1>);
+BM_READ(Loop_LinearSimdReduce<4>);
+BM_READ(Loop_StencilReloadAccess<1>);
+BM_READ(Loop_StencilShiftedAccess<1>);
+BM_READ(Loop_StencilReloadAccess<2>);
+BM_READ(Loop_StencilShiftedAccess<2>);
+BM_READ(Loop_ColumnIndexArrayAccess<2>);
+BM_READ(Loop_ColumnStridedAccess<2>);
+BM_READ(Loop_ColumnRuntimeStridedAccess<2>);
+BM_READ(Loop_ColumnIndexArrayAccess<8>);
+BM_READ(Loop_ColumnStridedAccess<8>);
+BM_READ(Loop_ColumnRuntimeStridedAccess<8>);
+
+// arrays well beyond the size of the last level cache
+#define BM_READ_LARGE( name ) BENCHMARK( name )->Unit(benchmark::kMillisecond)->Arg(1 << 25)
+
+BM_READ_LARGE(Loop_IndirectSimdReadAccess);
+BM_READ_LARGE(Loop_IndirectSimdReadAccessPrefetch);
+BM_READ_LARGE(Loop_LinearSimdWriteAccess);
+BM_READ_LARGE(Loop_LinearSimdStreamingWriteAccess);
+BM_READ_LARGE(Loop_ByteMaskAccess);
+BM_READ_LARGE(Loop_BitMaskAccess);
+BM_READ_LARGE(Loop_QuantizedCopyAccess);
+BM_READ_LARGE(Loop_QuantizedViewAccess);
+BENCHMARK_TEMPLATE(Loop_MixedPrecisionUpdate, double, simd_access::cast_encoding)
+  ->Unit(benchmark::kMillisecond)->Arg(1 << 25);
+BENCHMARK_TEMPLATE(Loop_MixedPrecisionUpdate, float, simd_access::cast_encoding)
+  ->Unit(benchmark::kMillisecond)->Arg(1 << 25);
+BENCHMARK_TEMPLATE(Loop_MixedPrecisionUpdate, std::uint16_t, simd_access::float16_encoding)
+  ->Unit(benchmark::kMillisecond)->Arg(1 << 25);
+BENCHMARK_TEMPLATE(Loop_MixedPrecisionUpdate, std::uint16_t, simd_access::bfloat16_encoding)
+  ->Unit(benchmark::kMillisecond)->Arg(1 << 25);
+
+#define BM_GRID( name ) BENCHMARK( name )->Unit(benchmark::kMicrosecond)->Arg(30)->Arg(62)
+
+BM_GRID(Loop_GridNestedWriteAccess);
+BM_GRID(Loop_GridNdWriteAccess);
@@ -0,0 +1,99 @@
+
+#include "benchmark/benchmark.h"
+#include <experimental/bits/simd.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/parallel_loop.hpp"
+
+namespace {
+
+constexpr size_t elementCount = 1 << 16;
+
+/**
+ * Test data of an irregular indirect loop: The iteration costs of the elements are skewed like the neighbour counts
+ * in an unstructured mesh. The expensive elements are clustered at the begin of the index range.
+ */
+struct SkewedData
+{
+  std::vector<double> values;
+  std::vector<int> costs;
+  std::vector<int> indices;
+  std::vector<double> result;
+
+  SkewedData() :
+    values(elementCount, 2.0),
+    costs(elementCount),
+    indices(elementCount),
+    result(elementCount)
+  {
+    for (size_t i = 0; i < elementCount; ++i)
+    {
+      costs[i] = i < elementCount / 8 ? 256 : 8;
+    }
+    std::iota(indices.begin(), indices.end(), 0);
+  }
+};
+
+template<int SimdSize>
+void SkewedBody(SkewedData& data, auto i, auto element)
+{
+  auto x = SIMD_ACCESS_V(data.values, element);
+  int cost;
+  if constexpr (std::is_integral_v<decltype(element)>)
+  {
+    cost = data.costs[element];
+  }
+  else
+  {
+    cost = stdx::hmax(SIMD_ACCESS_V(data.costs, element));
+  }
+  for (int k = 0; k < cost; ++k)
+  {
+    x = sqrt(x + 1.0);
+  }
+  SIMD_ACCESS(data.result, i) = x;
+}
+
+}
+
+void ParallelLoop_SkewedWorkStealing(benchmark::State& state)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  SkewedData data;
+  simd_access::thread_pool pool(unsigned(state.range(0)));
+  for (auto _ : state)
+  {
+    simd_access::parallel_loop_with_linear_index<vec_size>(pool, data.indices.begin(), data.indices.end(),
+      [&](auto i, auto element) { SkewedBody<vec_size>(data, i, element); });
+    benchmark::DoNotOptimize(data.result.data());
+  }
+  state.SetItemsProcessed(elementCount * state.iterations());
+}
+
+void ParallelLoop_SkewedStatic(benchmark::State& state)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  SkewedData data;
+  simd_access::thread_pool pool(unsigned(state.range(0)));
+  // one chunk per thread, thus no chunk can be stolen
+  const size_t chunk_size = (elementCount + pool.size() - 1) / pool.size();
+  for (auto _ : state)
+  {
+    simd_access::parallel_loop_with_linear_index<vec_size>(pool, data.indices.begin(), data.indices.end(),
+      [&](auto i, auto element) { SkewedBody<vec_size>(data, i, element); }, simd_access::ScalarResidualLoop,
+      chunk_size);
+    benchmark::DoNotOptimize(data.result.data());
+  }
+  state.SetItemsProcessed(elementCount * state.iterations());
+}
+
+#define BM_PARALLEL( name ) BENCHMARK( name )->Unit(benchmark::kMillisecond)->UseRealTime()->RangeMultiplier(2) \
+  ->Range(1, std::max(1u, std::thread::hardware_concurrency()))
+
+BM_PARALLEL(ParallelLoop_SkewedStatic);
+BM_PARALLEL(ParallelLoop_SkewedWorkStealing);
@@ -0,0 +1,340 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief A vector storing its elements in array-of-structure-of-simd layout.
+ *
+ * The elements are stored in blocks of `Lanes` elements. Within a block every scalar member is stored in a separate
+ * array of `Lanes` entries, i.e. a block has the layout of the structure-of-simd `simdized_value<Lanes>(T)`. Thus, a
+ * simd access to a whole element is a set of contiguous vector accesses to the same block, while the members of an
+ * element are still close to each other.
+ */
+
+#ifndef SIMD_ACCESS_AOSOA_VECTOR
+#define SIMD_ACCESS_AOSOA_VECTOR
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/soa_vector.hpp"
+
+namespace simd_access
+{
+
+/**
+ * Location of a scalar member of the elements of an `aosoa_vector` accessed by a simd index. Linear indices, whose
+ * lanes are in one block, are accessed by vector loads and stores, which are aligned, if the first lane is aligned to
+ * the vector size. All other indices are mapped to the positions of the elements in the
+ * blocks and accessed by gathers and scatters.
+ * @tparam T Type of the scalar member.
+ * @tparam Lanes Number of elements in a block.
+ * @tparam IndexType Type of the simd index.
+ */
+template<class T, int Lanes, class IndexType>
+struct aosoa_location
+{
+  using value_type = T;
+  /// The member in the first block.
+  T* base_;
+  /// Distance of the blocks in units of `T`.
+  size_t stride_;
+  /// The simd index.
+  IndexType indices_;
+
+  /// Alignment of the member arrays in a block (see `aosoa_vector`).
+  static constexpr size_t block_alignment = std::min<size_t>(Lanes * sizeof(T), 64);
+
+  /// Return the position of the member of an element relative to `base_`.
+  template<std::integral I>
+  I position(I i) const
+  {
+    return i / I(Lanes) * I(stride_) + i % I(Lanes);
+  }
+
+  /// Return the positions of the member of the elements in the lanes of a simd index relative to `base_`.
+  template<class I, class Abi>
+  auto position(const stdx::simd<I, Abi>& i) const
+  {
+    return i / I(Lanes) * I(stride_) + i % I(Lanes);
+  }
+
+  /// Call a functor with the location of the accessed members in the blocks.
+  /**
+   * @param fn Functor called with an `aligned_location`, a `linear_location` or an `indexed_location` (restricted to
+   *   the mask of the index).
+   * @return The result of `fn`.
+   */
+  decltype(auto) visit(auto&& fn) const
+  {
+    constexpr int simd_size = IndexType::size();
+    if constexpr (is_linear_index<IndexType>)
+    {
+      const size_t lane = size_t(indices_.index_ % Lanes);
+      if (lane + simd_size <= Lanes)
+      {
+        linear_location<T, simd_size> location{base_ + position(indices_.index_)};
+        if constexpr (block_alignment % (simd_size * sizeof(T)) == 0)
+        {
+          if (reinterpret_cast<std::uintptr_t>(location.base_) % (simd_size * sizeof(T)) == 0)
+          {
+            return fn(restricted(aligned_location<decltype(location)>{location}));
+          }
+        }
+        return fn(restricted(location));
+      }
+    }
+    auto positions = position(simd_indices());
+    return fn(restricted(indexed_location<T, simd_size, decltype(positions)>{base_, positions}));
+  }
+
+private:
+  auto simd_indices() const
+  {
+    constexpr int simd_size = IndexType::size();
+    if constexpr (requires { indices_.scalar_index(0); })
+    {
+      if constexpr (requires { requires !std::integral<decltype(indices_.index_)>; indices_.mask_; })
+      {
+        // entries of inactive lanes must not be read
+        return masked_indices<simd_size>(indices_.index_, indices_.mask_);
+      }
+      else
+      {
+        using index_type = std::remove_cvref_t<decltype(indices_.scalar_index(0))>;
+        return stdx::fixed_size_simd<index_type, simd_size>([&](int i) { return indices_.scalar_index(i); });
+      }
+    }
+    else
+    {
+      return stdx::fixed_size_simd<typename IndexType::value_type, simd_size>([&](int i) { return indices_[i]; });
+    }
+  }
+
+  auto restricted(const auto& location) const
+  {
+    if constexpr (requires { indices_.mask_; })
+    {
+      return make_masked_location(location, indices_.mask_);
+    }
+    else
+    {
+      return location;
+    }
+  }
+};
+
+template<class T, int Lanes, class IndexType>
+inline constexpr int location_simd_size<aosoa_location<T, Lanes, IndexType>> = IndexType::size();
+
+/**
+ * Restricts a location in an `aosoa_vector` to the active lanes of a simd mask.
+ * @param location The unrestricted location.
+ * @param mask Simd mask.
+ * @return The location with a masked simd index.
+ */
+template<class T, int Lanes, class IndexType, class MaskType>
+inline auto make_masked_location(const aosoa_location<T, Lanes, IndexType>& location, const MaskType& mask)
+{
+  auto indices = make_masked_index(location.indices_, mask);
+  return aosoa_location<T, Lanes, decltype(indices)>{location.base_, location.stride_, indices};
+}
+
+/**
+ * Loads a simd value from a member of the elements of an `aosoa_vector`.
+ * @param location The location in the container.
+ * @return A simd value.
+ */
+template<size_t ElementSize, class T, int Lanes, class IndexType>
+inline auto load(const aosoa_location<T, Lanes, IndexType>& location)
+{
+  return location.visit([](const auto& member_location) { return load<sizeof(T)>(member_location); });
+}
+
+/**
+ * Stores a simd value to a member of the elements of an `aosoa_vector`.
+ * @param location The location in the container.
+ * @param source The stored value.
+ */
+template<size_t ElementSize, class T, int Lanes, class IndexType>
+inline void store(const aosoa_location<T, Lanes, IndexType>& location, const auto& source)
+{
+  location.visit([&](const auto& member_location) { store<sizeof(T)>(member_location, source); });
+}
+
+/**
+ * Compound assignment to a member of the elements of an `aosoa_vector`. Duplicate indices are handled like for
+ * arrays (see `store_compound_indexed`).
+ */
+template<size_t ElementSize, class T, int Lanes, class IndexType>
+inline void store_compound(const aosoa_location<T, Lanes, IndexType>& location, const auto& source, auto&& op,
+  auto&& combine_op)
+{
+  location.visit([&](const auto& member_location)
+    {
+      store_compound<sizeof(T)>(member_location, source, op, combine_op);
+    });
+}
+
+/// Vector, which stores its elements in blocks of `Lanes` elements in structure-of-arrays layout (array of
+/// structure-of-simd).
+/**
+ * Simd accesses via `SIMD_ACCESS(v, i, .member)` are vector loads and stores, if the lanes of the index `i` are in one
+ * block. This is the case for all indices of `loop<SimdSize>` starting at 0, if `Lanes` is a multiple of `SimdSize`.
+ * These accesses are aligned, if the vector size in bytes divides the alignment of the member arrays.
+ * Other indices are gathered and scattered. Accesses to (sub-)structures load and store every scalar member
+ * separately from the same block. In contrast to `soa_vector`, the members of an element stay close to each other.
+ * The member arrays in a block are aligned to their size (up to 64 bytes).
+ * @tparam T Element type (see `soa_container`).
+ * @tparam Lanes Number of elements in a block.
+ */
+template<class T, int Lanes>
+class aosoa_vector :
+  public soa_container<aosoa_vector<T, Lanes>, T>
+{
+  static_assert(Lanes > 0);
+  using base = soa_container<aosoa_vector<T, Lanes>, T>;
+
+public:
+  /// Constructor creating an empty vector.
+  aosoa_vector() = default;
+
+  /// Constructor.
+  /**
+   * @param size Number of elements.
+   * @param value Value of the elements.
+   */
+  explicit aosoa_vector(size_t size, const T& value = T())
+  {
+    resize(size, value);
+  }
+
+  /// Return the number of elements.
+  size_t size() const { return size_; }
+
+  /// Return, whether the vector has no elements.
+  bool empty() const { return size_ == 0; }
+
+  /// Change the number of elements.
+  /**
+   * @param size New number of elements.
+   * @param value Value of the added elements.
+   */
+  void resize(size_t size, const T& value = T())
+  {
+    data_.resize((size + Lanes - 1) / Lanes * block_->size_);
+    for (size_t i = std::exchange(size_, size); i < size; ++i)
+    {
+      (*this)[i] = value;
+    }
+  }
+
+  /// Append an element.
+  void push_back(const T& value)
+  {
+    resize(size_ + 1, value);
+  }
+
+  /// Remove all elements.
+  void clear()
+  {
+    resize(0);
+  }
+
+  /// Return the array of a scalar member in the first block.
+  /**
+   * @param member The member of the prototype.
+   * @return Pointer to the member of the first element.
+   */
+  template<class MemberType>
+  MemberType* member_data(const MemberType& member)
+  {
+    return reinterpret_cast<MemberType*>(data_.data() + block_->offsets_[this->member_number(member)]);
+  }
+
+  template<class MemberType>
+  const MemberType* member_data(const MemberType& member) const
+  {
+    return reinterpret_cast<const MemberType*>(data_.data() + block_->offsets_[this->member_number(member)]);
+  }
+
+  /// Return the distance of the blocks in units of a scalar member.
+  size_t member_stride(const auto& member) const
+  {
+    return block_->size_ / sizeof(member);
+  }
+
+  /// Return a reference to a scalar member of an element.
+  /**
+   * @param member The member of the prototype.
+   * @param i Index of the element.
+   */
+  auto& scalar_member(const auto& member, size_t i)
+  {
+    return member_data(member)[i / Lanes * member_stride(member) + i % Lanes];
+  }
+
+  auto& scalar_member(const auto& member, size_t i) const
+  {
+    return member_data(member)[i / Lanes * member_stride(member) + i % Lanes];
+  }
+
+  /// Return the simd access to a scalar member.
+  /**
+   * @param member The member of the prototype.
+   * @param indices Simd index.
+   * @return A `value_access` to the member in the blocks.
+   */
+  template<class IndexType>
+  auto member_access(const auto& member, const IndexType& indices)
+  {
+    using location_type = aosoa_location<std::remove_cvref_t<decltype(member)>, Lanes, IndexType>;
+    return make_value_access<sizeof(member)>(location_type{member_data(member), member_stride(member), indices});
+  }
+
+  template<class IndexType>
+  auto member_access(const auto& member, const IndexType& indices) const
+  {
+    using location_type = aosoa_location<const std::remove_cvref_t<decltype(member)>, Lanes, IndexType>;
+    return make_value_access<sizeof(member)>(location_type{member_data(member), member_stride(member), indices});
+  }
+
+private:
+  /// Offsets of the member arrays in a block and size of a block in bytes.
+  struct block_layout
+  {
+    std::vector<size_t> offsets_;
+    size_t size_ = 0;
+
+    block_layout()
+    {
+      size_t alignment = 1;
+      for (size_t member_size : base::member_sizes())
+      {
+        size_t member_alignment = std::min<size_t>(Lanes * member_size, 64);
+        size_ = (size_ + member_alignment - 1) / member_alignment * member_alignment;
+        offsets_.push_back(size_);
+        size_ += Lanes * member_size;
+        alignment = std::max(alignment, member_alignment);
+      }
+      size_ = (size_ + alignment - 1) / alignment * alignment;
+    }
+  };
+
+  static const block_layout& block()
+  {
+    static const block_layout result;
+    return result;
+  }
+
+  const block_layout* block_ = &block();
+  size_t size_ = 0;
+  std::vector<std::byte, aligned_allocator<std::byte>> data_;
+};
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_AOSOA_VECTOR
@@ -0,0 +1,310 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief A view of an array of bits (e.g. flags packed into `std::uint64_t` words), whose simd accesses are simd masks.
+ *
+ * Simd accesses to consecutive bits extract the bits of a vector from one or two words by shifts and expand them to a
+ * simd mask. Indirect accesses gather the words and extract the bits by per-lane shifts. Stores pack the mask to bits
+ * and update the words by read-modify-write, thus different threads must not write to the same word concurrently.
+ */
+
+#ifndef SIMD_ACCESS_BIT_VIEW
+#define SIMD_ACCESS_BIT_VIEW
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+#include "simd_access/simd_access.hpp"
+
+namespace simd_access
+{
+
+/// Number of bits stored in a word of a bit array.
+template<class WordType>
+inline constexpr int word_bits = std::numeric_limits<std::remove_const_t<WordType>>::digits;
+
+/// Element type of the simd masks of bits, which has a lane bit for every lane of a vector.
+template<int SimdSize>
+using bit_lane_type = std::conditional_t<(SimdSize <= 32), std::uint32_t, std::uint64_t>;
+
+/// Simd mask loaded from an array of bits. It converts implicitly to the fixed size masks of other element types.
+template<int SimdSize>
+using bit_mask = stdx::fixed_size_simd_mask<bit_lane_type<SimdSize>, SimdSize>;
+
+/**
+ * Expands bits to a simd mask by broadcasting them to all lanes and testing the lane bit.
+ * @tparam SimdSize Vector size, at most 64.
+ * @param bits Bit `i` is the value of lane `i`, higher bits are ignored.
+ * @return The simd mask.
+ */
+template<int SimdSize>
+inline bit_mask<SimdSize> bits_to_mask(std::uint64_t bits)
+{
+  static_assert(SimdSize <= 64);
+  using lane_type = bit_lane_type<SimdSize>;
+  using simd_type = stdx::fixed_size_simd<lane_type, SimdSize>;
+  return (simd_type(lane_type(bits)) & simd_type([](int i) { return lane_type(1) << i; })) != 0;
+}
+
+/**
+ * Packs a simd mask to bits.
+ * @tparam SimdSize Vector size, at most 64.
+ * @param mask Fixed size simd mask of any element type.
+ * @return Bit `i` is the value of lane `i`, higher bits are zero.
+ */
+template<int SimdSize>
+inline std::uint64_t mask_to_bits(const auto& mask)
+{
+  static_assert(SimdSize <= 64);
+  using lane_type = bit_lane_type<SimdSize>;
+  using simd_type = stdx::fixed_size_simd<lane_type, SimdSize>;
+  simd_type lanes = 0;
+  stdx::where(typename simd_type::mask_type(mask), lanes) = simd_type([](int i) { return lane_type(1) << i; });
+  return stdx::reduce(lanes, std::bit_or<>());
+}
+
+/// Lane bits of all lanes of a vector.
+template<int SimdSize>
+inline constexpr std::uint64_t all_lane_bits =
+  SimdSize == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << SimdSize) - 1;
+
+/**
+ * Location of the bits of an array of bits accessed by a simd index. The bit `b` is the bit `b % word_bits` of the
+ * word `b / word_bits`.
+ * @tparam WordType Unsigned integral type of the (possibly const) words.
+ * @tparam IndexType Type of the simd index.
+ */
+template<class WordType, class IndexType>
+struct bit_location
+{
+  using value_type = bool;
+  /// Pointer to the first word of the array.
+  WordType* words_;
+  /// The simd index of the bits.
+  IndexType indices_;
+
+  /// Return the lane bits of the active lanes of the index.
+  std::uint64_t active_lanes() const
+  {
+    if constexpr (requires { indices_.mask_; })
+    {
+      return mask_to_bits<IndexType::size()>(indices_.mask_);
+    }
+    else
+    {
+      return all_lane_bits<IndexType::size()>;
+    }
+  }
+
+  /// Return the indices of the active bits as simd value, indices of inactive lanes are zero.
+  auto bit_indices() const
+  {
+    return stdx::fixed_size_simd<size_t, IndexType::size()>([&](int i)
+      {
+        return is_active_lane(indices_, i) ? size_t(get_index(indices_, i)) : size_t(0);
+      });
+  }
+};
+
+template<class WordType, class IndexType>
+inline constexpr int location_simd_size<bit_location<WordType, IndexType>> = IndexType::size();
+
+/**
+ * Restricts a location in an array of bits to the active lanes of a simd mask.
+ * @param location The unrestricted location.
+ * @param mask Simd mask.
+ * @return The location with a masked simd index.
+ */
+template<class WordType, class IndexType, class MaskType>
+inline auto make_masked_location(const bit_location<WordType, IndexType>& location, const MaskType& mask)
+{
+  auto indices = make_masked_index(location.indices_, mask);
+  return bit_location<WordType, decltype(indices)>{location.words_, indices};
+}
+
+/**
+ * Loads bits as simd mask. Consecutive bits are shifted out of the (at most two) words containing them, words
+ * containing only inactive lanes aren't read. Other bits are extracted from gathered words by per-lane shifts.
+ * @tparam ElementSize Unused, the bits are addressed by the words.
+ * @param location The location in the array of bits.
+ * @return The simd mask, inactive lanes are false.
+ */
+template<size_t ElementSize, class WordType, class IndexType>
+inline auto load(const bit_location<WordType, IndexType>& location)
+{
+  constexpr int simd_size = IndexType::size();
+  constexpr int bits_per_word = word_bits<WordType>;
+  const std::uint64_t active = location.active_lanes();
+  if constexpr (is_linear_index<IndexType>)
+  {
+    static_assert(simd_size <= bits_per_word, "the bits of a vector must be contained in two words");
+    if (active == 0)
+    {
+      return bit_mask<simd_size>(false);
+    }
+    const size_t first = location.indices_.index_;
+    const auto* words = location.words_ + first / bits_per_word;
+    const int shift = int(first % bits_per_word);
+    std::uint64_t bits = std::uint64_t(words[0]) >> shift;
+    if (shift + std::bit_width(active) > bits_per_word)
+    {
+      bits |= std::uint64_t(words[1]) << (bits_per_word - shift);
+    }
+    return bits_to_mask<simd_size>(bits & active);
+  }
+  else
+  {
+    using word_simd = stdx::fixed_size_simd<std::remove_const_t<WordType>, simd_size>;
+    const auto bit_indices = location.bit_indices();
+    const auto word_indices = bit_indices / size_t(bits_per_word);
+    using indexed_type = indexed_location<WordType, simd_size, std::remove_const_t<decltype(word_indices)>>;
+    const word_simd words = load<sizeof(WordType)>(masked_location<indexed_type, bit_mask<simd_size>>{
+      {location.words_, word_indices}, bits_to_mask<simd_size>(active)});
+    const auto shifts = stdx::static_simd_cast<word_simd>(bit_indices % size_t(bits_per_word));
+    return bit_mask<simd_size>(((words >> shifts) & 1) != 0);
+  }
+}
+
+/**
+ * Stores a simd mask to bits. Consecutive bits are packed and merged into the (at most two) words containing them.
+ * Other bits are updated one by one, thus bits of different lanes in the same word are all stored.
+ * @tparam ElementSize Unused, the bits are addressed by the words.
+ * @param location The location in the array of bits.
+ * @param source Fixed size simd mask of any element type or `bool`, which is broadcasted.
+ */
+template<size_t ElementSize, class WordType, class IndexType>
+inline void store(const bit_location<WordType, IndexType>& location, const auto& source)
+{
+  constexpr int simd_size = IndexType::size();
+  constexpr int bits_per_word = word_bits<WordType>;
+  const std::uint64_t active = location.active_lanes();
+  const std::uint64_t bits = mask_to_bits<simd_size>(bit_mask<simd_size>(source));
+  auto merge = [](WordType& word, std::uint64_t merged, std::uint64_t value)
+    {
+      word = WordType((std::uint64_t(word) & ~merged) | (value & merged));
+    };
+  if constexpr (is_linear_index<IndexType>)
+  {
+    static_assert(simd_size <= bits_per_word, "the bits of a vector must be contained in two words");
+    if (active == 0)
+    {
+      return;
+    }
+    const size_t first = location.indices_.index_;
+    auto* words = location.words_ + first / bits_per_word;
+    const int shift = int(first % bits_per_word);
+    merge(words[0], active << shift, bits << shift);
+    if (shift + std::bit_width(active) > bits_per_word)
+    {
+      merge(words[1], active >> (bits_per_word - shift), bits >> (bits_per_word - shift));
+    }
+  }
+  else
+  {
+    for (int i = 0; i < simd_size; ++i)
+    {
+      if (is_active_lane(location.indices_, i))
+      {
+        const size_t bit_index = get_index(location.indices_, i);
+        merge(location.words_[bit_index / bits_per_word], std::uint64_t(1) << (bit_index % bits_per_word),
+          ((bits >> i) & 1) << (bit_index % bits_per_word));
+      }
+    }
+  }
+}
+
+/// Reference to a bit of an array of bits, which is returned by scalar accesses.
+/**
+ * @tparam WordType Unsigned integral type of the (possibly const) words.
+ */
+template<class WordType>
+struct bit_reference
+{
+  /// The word containing the bit.
+  WordType* word_;
+  /// The word, in which only the referenced bit is set.
+  std::remove_const_t<WordType> bit_;
+
+  /// Return the value of the bit.
+  bool to_simd() const
+  {
+    return (*word_ & bit_) != 0;
+  }
+
+  /// Return the value of the bit.
+  operator bool() const
+  {
+    return to_simd();
+  }
+
+  /// Assignment operator, which sets or clears the bit.
+  void operator=(bool value) &&
+  {
+    *word_ = WordType(value ? *word_ | bit_ : *word_ & ~bit_);
+  }
+};
+
+/// View of an array of bits packed into unsigned integral words, e.g. a bitset of flags.
+/**
+ * `SIMD_ACCESS(view, i)` loads the bits of a simd index as simd mask, which can be used directly in `where`
+ * expressions, and stores a simd mask (or a broadcasted `bool`) to the bits. Consecutive indices are supported for
+ * vectors of up to `word_bits<WordType>` lanes, masked, strided and indirect indices (e.g. `index_array`) as well.
+ * Scalar accesses (`view[i]`) return a `bit_reference`.
+ * @tparam WordType Unsigned integral type of the (possibly const) words.
+ */
+template<class WordType = std::uint64_t>
+  requires std::unsigned_integral<std::remove_const_t<WordType>>
+struct bit_view
+{
+  static constexpr bool has_custom_layout = true;
+  using value_type = bool;
+
+  /// Pointer to the first word.
+  WordType* words_;
+  /// Number of bits.
+  size_t size_;
+
+  /// Return the number of words storing a number of bits.
+  static constexpr size_t word_count(size_t size)
+  {
+    return (size + word_bits<WordType> - 1) / word_bits<WordType>;
+  }
+
+  /// Return the number of bits.
+  size_t size() const { return size_; }
+
+  /// Return a reference to a bit.
+  auto operator[](size_t i) const
+  {
+    using bit_type = std::remove_const_t<WordType>;
+    return bit_reference<WordType>{words_ + i / word_bits<WordType>, bit_type(bit_type(1) << i % word_bits<WordType>)};
+  }
+
+  /// Return the simd access to the bits of a simd index. Called by `SIMD_ACCESS`.
+  auto simd_subobject(const auto& indices) const
+  {
+    return make_value_access<0>(bit_location<WordType, std::remove_cvref_t<decltype(indices)>>{words_, indices});
+  }
+};
+
+/**
+ * Creates a view of an array of bits.
+ * @param words Pointer to the first word, the array must have `bit_view<WordType>::word_count(size)` words.
+ * @param size Number of bits.
+ * @return The view.
+ */
+template<class WordType>
+inline auto make_bit_view(WordType* words, size_t size)
+{
+  return bit_view<WordType>{words, size};
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_BIT_VIEW
@@ -0,0 +1,313 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Encodings of values, which are stored in a more compact type than the type they are computed in.
+ *
+ * An encoding converts stored values to the compute type (`decode`) and computed values to the stored type
+ * (`encode`). Both functions take a scalar or simd destination and a source of the same vector size. They are called
+ * on an object of the encoding, thus an encoding may carry parameters (e.g. `linear_quantization`). Computed values
+ * are rounded to nearest even.
+ */
+
+#ifndef SIMD_ACCESS_ENCODING
+#define SIMD_ACCESS_ENCODING
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#include "simd_access/base.hpp"
+#include "simd_access/intrinsics.hpp"
+
+namespace simd_access
+{
+
+/**
+ * Reinterprets the bit patterns of the lanes of a simd value as another element type of the same size.
+ * @tparam ResultType Simd type of the result.
+ * @param x Simd value.
+ * @return A simd value with the bit pattern of `x`.
+ */
+template<class ResultType, class T, int SimdSize>
+inline ResultType simd_bit_cast(const stdx::fixed_size_simd<T, SimdSize>& x)
+{
+  using result_value_type = typename ResultType::value_type;
+  static_assert(sizeof(result_value_type) == sizeof(T) && ResultType::size() == SimdSize);
+  if constexpr ((SimdSize & (SimdSize - 1)) == 0)
+  {
+    return from_native<ResultType>(to_native<vector_extension_t<T, SimdSize>>(x));
+  }
+  else
+  {
+    return ResultType([&](int i) { return std::bit_cast<result_value_type>(T(x[i])); });
+  }
+}
+
+/**
+ * Converts a half precision (IEEE 754 binary16) bit pattern to a single precision value.
+ * @param bits The bit pattern.
+ * @return The value.
+ */
+inline float float16_to_float(std::uint16_t bits)
+{
+  const std::uint32_t sign = std::uint32_t(bits & 0x8000u) << 16;
+  const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+  const std::uint32_t mantissa = bits & 0x3FFu;
+  if (exponent == 0x1Fu)
+  {
+    return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+  }
+  if (exponent == 0)
+  {
+    // subnormal values are exact multiples of 2^-24
+    const float magnitude = float(mantissa) * 0x1p-24f;
+    return sign != 0 ? -magnitude : magnitude;
+  }
+  return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+/**
+ * Converts a single precision value to a half precision (IEEE 754 binary16) bit pattern. The value is rounded to
+ * nearest even, values beyond the range of half precision become infinite, NaNs become quiet NaNs.
+ * @param value The value.
+ * @return The bit pattern.
+ */
+inline std::uint16_t float_to_float16(float value)
+{
+  std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  const std::uint32_t sign = (bits >> 16) & 0x8000u;
+  bits &= 0x7FFFFFFFu;
+  std::uint32_t result;
+  if (bits >= 0x47800000u)
+  {
+    // at least 2^16, i.e. infinite after rounding, or NaN
+    result = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+  }
+  else if (bits < 0x38800000u)
+  {
+    // below 2^-14, the addition of 0.5 rounds to a multiple of 2^-24 in the low mantissa bits
+    result = std::bit_cast<std::uint32_t>(std::bit_cast<float>(bits) + 0.5f) - 0x3F000000u;
+  }
+  else
+  {
+    const std::uint32_t odd = (bits >> 13) & 1u;
+    result = (bits - 0x38000000u + 0xFFFu + odd) >> 13;
+  }
+  return std::uint16_t(result | sign);
+}
+
+/**
+ * Converts a bfloat16 bit pattern (the upper half of a single precision value) to a single precision value.
+ * @param bits The bit pattern.
+ * @return The value.
+ */
+inline float bfloat16_to_float(std::uint16_t bits)
+{
+  return std::bit_cast<float>(std::uint32_t(bits) << 16);
+}
+
+/**
+ * Converts a single precision value to a bfloat16 bit pattern. The value is rounded to nearest even, NaNs stay quiet
+ * NaNs.
+ * @param value The value.
+ * @return The bit pattern.
+ */
+inline std::uint16_t float_to_bfloat16(float value)
+{
+  const std::uint32_t bits = std::bit_cast<std::uint32_t>(value);
+  if (value != value)
+  {
+    return std::uint16_t((bits >> 16) | 0x40u);
+  }
+  return std::uint16_t((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16);
+}
+
+/// Encoding of values, which are stored in an arithmetic type and converted by value (e.g. `float` to `double`).
+struct cast_encoding
+{
+  /// Converts a scalar or simd value to the type of `dest`.
+  template<class DestType, class SrcType>
+  static void convert(DestType& dest, const SrcType& source)
+  {
+    if constexpr (is_stdx_simd<DestType> && is_stdx_simd<SrcType>)
+    {
+      dest = stdx::static_simd_cast<DestType>(source);
+    }
+    else
+    {
+      dest = DestType(source);
+    }
+  }
+
+  /// Converts stored values to the compute type.
+  static void decode(auto& dest, const auto& stored)
+  {
+    convert(dest, stored);
+  }
+
+  /// Converts computed values to the stored type.
+  static void encode(auto& dest, const auto& value)
+  {
+    convert(dest, value);
+  }
+};
+
+/**
+ * Encoding of half precision (IEEE 754 binary16) values, which are stored as `std::uint16_t` bit patterns. The values
+ * are converted via single precision, by F16C or AVX-512F instructions, if available.
+ */
+struct float16_encoding
+{
+  /// Converts a stored bit pattern to the compute type.
+  static void decode(auto& dest, std::uint16_t stored)
+  {
+    cast_encoding::convert(dest, float16_to_float(stored));
+  }
+
+  /// Converts stored bit patterns to the compute type.
+  template<int SimdSize>
+  static void decode(auto& dest, const stdx::fixed_size_simd<std::uint16_t, SimdSize>& stored)
+  {
+    if constexpr (has_native_float16_conversion<SimdSize>)
+    {
+      cast_encoding::convert(dest, native_float16_to_float(stored));
+    }
+    else
+    {
+      cast_encoding::convert(dest,
+        stdx::fixed_size_simd<float, SimdSize>([&](int i) { return float16_to_float(stored[i]); }));
+    }
+  }
+
+  /// Converts a computed value to a stored bit pattern.
+  static void encode(std::uint16_t& dest, const auto& value)
+  {
+    dest = float_to_float16(float(value));
+  }
+
+  /// Converts computed values to stored bit patterns.
+  template<int SimdSize>
+  static void encode(stdx::fixed_size_simd<std::uint16_t, SimdSize>& dest, const auto& value)
+  {
+    stdx::fixed_size_simd<float, SimdSize> values;
+    cast_encoding::convert(values, value);
+    if constexpr (has_native_float16_conversion<SimdSize>)
+    {
+      dest = native_float_to_float16(values);
+    }
+    else
+    {
+      dest = stdx::fixed_size_simd<std::uint16_t, SimdSize>([&](int i) { return float_to_float16(values[i]); });
+    }
+  }
+};
+
+/**
+ * Encoding of bfloat16 values, which are stored as `std::uint16_t` bit patterns. A bfloat16 value is the upper half
+ * of a single precision value, thus the values are converted via single precision by integer shifts.
+ */
+struct bfloat16_encoding
+{
+  /// Converts a stored bit pattern to the compute type.
+  static void decode(auto& dest, std::uint16_t stored)
+  {
+    cast_encoding::convert(dest, bfloat16_to_float(stored));
+  }
+
+  /// Converts stored bit patterns to the compute type.
+  template<int SimdSize>
+  static void decode(auto& dest, const stdx::fixed_size_simd<std::uint16_t, SimdSize>& stored)
+  {
+    using bits_simd = stdx::fixed_size_simd<std::uint32_t, SimdSize>;
+    const bits_simd bits = stdx::static_simd_cast<bits_simd>(stored) << 16;
+    cast_encoding::convert(dest, simd_bit_cast<stdx::fixed_size_simd<float, SimdSize>>(bits));
+  }
+
+  /// Converts a computed value to a stored bit pattern.
+  static void encode(std::uint16_t& dest, const auto& value)
+  {
+    dest = float_to_bfloat16(float(value));
+  }
+
+  /// Converts computed values to stored bit patterns.
+  template<int SimdSize>
+  static void encode(stdx::fixed_size_simd<std::uint16_t, SimdSize>& dest, const auto& value)
+  {
+    using bits_simd = stdx::fixed_size_simd<std::uint32_t, SimdSize>;
+    stdx::fixed_size_simd<float, SimdSize> values;
+    cast_encoding::convert(values, value);
+    const auto bits = simd_bit_cast<bits_simd>(values);
+    bits_simd rounded = (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+    stdx::where(typename bits_simd::mask_type(values != values), rounded) = (bits >> 16) | 0x40u;
+    dest = stdx::static_simd_cast<stdx::fixed_size_simd<std::uint16_t, SimdSize>>(rounded);
+  }
+};
+
+/**
+ * Encoding of values, which are quantized to an integral type with a scale and an offset: a stored value `q`
+ * represents the value `scale_ * q + offset_`. Computed values are quantized to the nearest stored value, values
+ * beyond the range of the integral type saturate, NaNs become zero. The conversions are computed in `T`, which must
+ * represent all values of the integral type exactly.
+ * @tparam T Type of the scale and the offset.
+ */
+template<class T = float>
+struct linear_quantization
+{
+  /// Distance of the values represented by consecutive stored values.
+  T scale_;
+  /// Value represented by a stored zero.
+  T offset_;
+
+  /// Converts stored values to the compute type.
+  void decode(auto& dest, const auto& stored) const
+  {
+    cast_encoding::convert(dest, dequantize(stored));
+  }
+
+  /// Converts computed values to the stored type.
+  template<class DestType>
+  void encode(DestType& dest, const auto& value) const
+  {
+    if constexpr (is_stdx_simd<DestType>)
+    {
+      using stored_type = typename DestType::value_type;
+      static_assert(std::numeric_limits<stored_type>::digits <= std::numeric_limits<T>::digits);
+      stdx::fixed_size_simd<T, DestType::size()> values;
+      cast_encoding::convert(values, value);
+      values = stdx::nearbyint((values - offset_) / scale_);
+      stdx::where(values != values, values) = T(0);
+      values = stdx::clamp(values, decltype(values)(T(std::numeric_limits<stored_type>::lowest())),
+        decltype(values)(T(std::numeric_limits<stored_type>::max())));
+      dest = stdx::static_simd_cast<DestType>(values);
+    }
+    else
+    {
+      static_assert(std::numeric_limits<DestType>::digits <= std::numeric_limits<T>::digits);
+      T x = std::nearbyint((T(value) - offset_) / scale_);
+      dest = x != x ? DestType(0) : DestType(std::clamp(x, T(std::numeric_limits<DestType>::lowest()),
+        T(std::numeric_limits<DestType>::max())));
+    }
+  }
+
+private:
+  template<class StoredType>
+  auto dequantize(const StoredType& stored) const
+  {
+    if constexpr (is_stdx_simd<StoredType>)
+    {
+      return stdx::static_simd_cast<stdx::fixed_size_simd<T, StoredType::size()>>(stored) * scale_ + offset_;
+    }
+    else
+    {
+      return T(stored) * scale_ + offset_;
+    }
+  }
+};
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_ENCODING
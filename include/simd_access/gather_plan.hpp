@@ -0,0 +1,278 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Inspector-executor loops over index ranges, which are iterated repeatedly.
+ *
+ * A `gather_plan` inspects an index range once and classifies each simd chunk of the range. Loops driven by the plan
+ * call the function with an `index` for contiguous chunks and with a strided index for strided chunks, thus their
+ * accesses become vector loads and stores or pitched loads instead of gathers and scatters.
+ */
+
+#ifndef SIMD_ACCESS_GATHER_PLAN
+#define SIMD_ACCESS_GATHER_PLAN
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#include "simd_access/simd_loop.hpp"
+
+namespace simd_access
+{
+
+/// Access pattern of the indices of a simd chunk.
+enum class chunk_kind : unsigned char
+{
+  /// The indices are `k, k+1, ..., k+SimdSize-1`.
+  contiguous,
+  /// The indices are `k, k+s, ..., k+(SimdSize-1)*s` with a constant stride `s` other than 0 and 1.
+  strided,
+  /// The indices don't follow a pattern.
+  random
+};
+
+/// Result of the inspection of an index range, which drives simd loops over this range.
+/**
+ * The plan refers to the index range, thus the range must outlive the plan and must not be modified after the
+ * inspection.
+ * @tparam SimdSize Vector size.
+ * @tparam IteratorType Type of the random access iterator defining the range of indices.
+ */
+template<int SimdSize, std::random_access_iterator IteratorType>
+class gather_plan
+{
+public:
+  using index_type = std::remove_cvref_t<std::iter_value_t<IteratorType>>;
+
+  /// Constructor, inspects the index range.
+  /**
+   * @param start Inclusive start of the range of indices.
+   * @param end Exclusive end of the range of indices.
+   */
+  gather_plan(IteratorType start, const IteratorType& end) :
+    start_(start),
+    end_(end)
+  {
+    const size_t chunk_count = size_t(end - start) / SimdSize;
+    chunks_.reserve(chunk_count);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+    {
+      chunks_.push_back(inspect(start + std::iter_difference_t<IteratorType>(chunk * SimdSize)));
+      ++kind_counts_[size_t(chunks_.back().kind_)];
+      max_span_ = std::max(max_span_, chunks_.back().span_);
+      duplicate_count_ += chunks_.back().has_duplicates_;
+    }
+  }
+
+  /// Return the start of the index range.
+  const IteratorType& begin() const { return start_; }
+
+  /// Return the end of the index range.
+  const IteratorType& end() const { return end_; }
+
+  /// Return the number of simd chunks, i.e. the number of indices without the residual iterations divided by
+  /// `SimdSize`.
+  size_t chunk_count() const { return chunks_.size(); }
+
+  /// Return the access pattern of a chunk.
+  /**
+   * @param chunk Number of the chunk in the range [0, chunk_count()).
+   * @return The access pattern of the indices `begin()[chunk * SimdSize]` up to
+   *   `begin()[chunk * SimdSize + SimdSize - 1]`.
+   */
+  chunk_kind kind(size_t chunk) const { return chunks_[chunk].kind_; }
+
+  /// Return the stride of a chunk.
+  /**
+   * @param chunk Number of the chunk in the range [0, chunk_count()).
+   * @return The difference of consecutive indices of the chunk, or 0 for random chunks.
+   */
+  std::ptrdiff_t stride(size_t chunk) const { return chunks_[chunk].stride_; }
+
+  /// Return the span of the indices of a chunk.
+  /**
+   * @param chunk Number of the chunk in the range [0, chunk_count()).
+   * @return The difference of the largest and the smallest index of the chunk. All elements accessed by the chunk lie
+   *   within `span(chunk) + 1` consecutive elements.
+   */
+  size_t span(size_t chunk) const { return chunks_[chunk].span_; }
+
+  /// Return, whether the indices of a chunk lie within a window of consecutive elements.
+  /**
+   * Gathers of a local chunk touch only a few cache lines, e.g. a chunk is local to a window of `64 / sizeof(T)`
+   * elements of type `T`, if it accesses at most two cache lines.
+   * @param chunk Number of the chunk in the range [0, chunk_count()).
+   * @param window Number of consecutive elements.
+   * @return True, if `span(chunk) < window`.
+   */
+  bool is_local(size_t chunk, size_t window) const { return chunks_[chunk].span_ < window; }
+
+  /// Return the number of chunks, whose indices lie within a window of consecutive elements (see `is_local`).
+  size_t local_count(size_t window) const
+  {
+    return size_t(std::count_if(chunks_.begin(), chunks_.end(), [=](const chunk_info& c) { return c.span_ < window; }));
+  }
+
+  /// Return the largest span of the indices of a chunk (see `span`).
+  size_t max_span() const { return max_span_; }
+
+  /// Return, whether a chunk contains duplicate indices.
+  /**
+   * @param chunk Number of the chunk in the range [0, chunk_count()).
+   * @return True, if at least two indices of the chunk are equal.
+   */
+  bool has_duplicates(size_t chunk) const { return chunks_[chunk].has_duplicates_; }
+
+  /// Return the number of chunks of an access pattern.
+  /**
+   * @param kind Access pattern.
+   * @return The number of chunks, whose indices follow `kind`.
+   */
+  size_t count(chunk_kind kind) const { return kind_counts_[size_t(kind)]; }
+
+  /// Return the number of chunks containing duplicate indices.
+  size_t duplicate_count() const { return duplicate_count_; }
+
+private:
+  struct chunk_info
+  {
+    chunk_kind kind_;
+    bool has_duplicates_;
+    std::ptrdiff_t stride_;
+    size_t span_;
+  };
+
+  /// Inspects the indices of a chunk.
+  static chunk_info inspect(IteratorType chunk)
+  {
+    std::array<index_type, SimdSize> indices;
+    std::copy(chunk, chunk + SimdSize, indices.begin());
+    const auto stride = SimdSize > 1 ? std::ptrdiff_t(indices[1]) - std::ptrdiff_t(indices[0]) : std::ptrdiff_t(1);
+    bool is_linear = true;
+    for (int i = 2; i < SimdSize && is_linear; ++i)
+    {
+      is_linear = std::ptrdiff_t(indices[i]) - std::ptrdiff_t(indices[i - 1]) == stride;
+    }
+    if (is_linear && stride != 0)
+    {
+      return { stride == 1 ? chunk_kind::contiguous : chunk_kind::strided, false, stride,
+        size_t(stride < 0 ? -stride : stride) * (SimdSize - 1) };
+    }
+    std::sort(indices.begin(), indices.end());
+    return { chunk_kind::random, std::adjacent_find(indices.begin(), indices.end()) != indices.end(), 0,
+      size_t(std::ptrdiff_t(indices.back()) - std::ptrdiff_t(indices.front())) };
+  }
+
+  IteratorType start_;
+  IteratorType end_;
+  std::vector<chunk_info> chunks_;
+  std::array<size_t, 3> kind_counts_ = {};
+  size_t duplicate_count_ = 0;
+  size_t max_span_ = 0;
+};
+
+/**
+ * Calls a function with the simd index matching the access pattern of a chunk of an inspected index range, i.e. with
+ * an `index<SimdSize, IndexType>` for contiguous chunks, with a `strided_index<SimdSize, Stride, IndexType>` for the
+ * small positive strides 2, 3 and 4, which are loaded by pitched loads, with a `runtime_strided_index<SimdSize,
+ * IndexType>` for other positive strides and with the `index_array<SimdSize, IteratorType>` otherwise. Chunks with a
+ * negative stride are accessed by the index array, since the order of their lanes is reversed in memory.
+ * @tparam SimdSize Vector size.
+ * @tparam IteratorType Deduced type of the random access iterator defining the range of indices.
+ * @param plan Inspected index range.
+ * @param chunk Number of the chunk in the range [0, plan.chunk_count()).
+ * @param simd_i Index array of the chunk.
+ * @param call Function called with the simd index.
+ */
+template<int SimdSize, class IteratorType>
+inline void invoke_planned_chunk(const gather_plan<SimdSize, IteratorType>& plan, size_t chunk,
+  const index_array<SimdSize, IteratorType>& simd_i, auto&& call)
+{
+  using IndexType = typename gather_plan<SimdSize, IteratorType>::index_type;
+  const IndexType first = *simd_i.index_;
+  if (plan.kind(chunk) == chunk_kind::contiguous)
+  {
+    call(index<SimdSize, IndexType>{first});
+    return;
+  }
+  if (plan.kind(chunk) == chunk_kind::strided && plan.stride(chunk) > 0)
+  {
+    switch (plan.stride(chunk))
+    {
+      case 2:
+        call(strided_index<SimdSize, 2, IndexType>{first});
+        return;
+      case 3:
+        call(strided_index<SimdSize, 3, IndexType>{first});
+        return;
+      case 4:
+        call(strided_index<SimdSize, 4, IndexType>{first});
+        return;
+      default:
+        call(runtime_strided_index<SimdSize, IndexType>{first, IndexType(plan.stride(chunk))});
+        return;
+    }
+  }
+  call(simd_i);
+}
+
+/**
+ * Simd-ized iteration over a function using an inspected index range. The function is called with the simd index
+ * matching the access pattern of each chunk (see `invoke_planned_chunk`). Thus, the accesses of contiguous chunks
+ * become vector loads and stores and the accesses of strided chunks avoid loading the indices.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @tparam IteratorType Deduced type of the random access iterator defining the range of indices.
+ * @param plan Inspected index range.
+ * @param fn Generic function to be called. Takes one argument, whose type is either `index<SimdSize, IndexType>`,
+ *   `strided_index<SimdSize, Stride, IndexType>`, `runtime_strided_index<SimdSize, IndexType>`,
+ *   `index_array<SimdSize, IteratorType>`, `masked_index_array<SimdSize, IteratorType>` or `IndexType`.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ */
+template<int SimdSize, auto ... Args, class IteratorType, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void loop(const gather_plan<SimdSize, IteratorType>& plan, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+{
+  index_array<SimdSize, IteratorType> simd_i{plan.begin()};
+  for (size_t chunk = 0, chunk_count = plan.chunk_count(); chunk < chunk_count; ++chunk, simd_i.index_ += SimdSize)
+  {
+    invoke_planned_chunk(plan, chunk, simd_i, [&](const auto& planned_i) { invoke_loop_body<Args...>(fn, planned_i); });
+  }
+  loop<SimdSize, Args...>(simd_i.index_, plan.end(), fn, residualLoopPolicy);
+}
+
+/**
+ * Simd-ized iteration over a function using an inspected index range and passing the linear index. The indirect
+ * index passed to the function matches the access pattern of each chunk (see `invoke_planned_chunk`).
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @tparam IteratorType Deduced type of the random access iterator defining the range of indices.
+ * @param plan Inspected index range.
+ * @param fn Generic function to be called. Takes two arguments, the linear index and the indirect index (see
+ *   `loop_with_linear_index`).
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop_with_linear_index`).
+ */
+template<int SimdSize, auto ... Args, class IteratorType, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void loop_with_linear_index(const gather_plan<SimdSize, IteratorType>& plan, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+{
+  index_array<SimdSize, IteratorType> simd_i{plan.begin()};
+  index<SimdSize, size_t> i{0};
+  for (size_t chunk = 0, chunk_count = plan.chunk_count(); chunk < chunk_count;
+       ++chunk, i.index_ += SimdSize, simd_i.index_ += SimdSize)
+  {
+    invoke_planned_chunk(plan, chunk, simd_i,
+      [&](const auto& planned_i) { invoke_loop_body<Args...>(fn, i, planned_i); });
+  }
+  loop_with_linear_index<SimdSize, Args...>(simd_i.index_, plan.end(), shift_linear_index(fn, i.index_),
+    residualLoopPolicy);
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_GATHER_PLAN
@@ -10,7 +10,10 @@
 
 #include "simd_access/base.hpp"
 #include "simd_access/location.hpp"
+#include <array>
+#include <concepts>
 #include <type_traits>
+#include <utility>
 
 namespace simd_access
 {
@@ -64,6 +67,167 @@ struct index
   }
 };
 
+/// Class representing a simd index to a consecutive sequence of elements, which are written by non-temporal
+/// (streaming) stores.
+/**
+ * The index behaves like `index`, but accesses via this index are streaming accesses (see
+ * `value_access::streaming()`).
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam IndexType Type of the index.
+ */
+template<int SimdSize, class IndexType = size_t>
+struct streaming_index : index<SimdSize, IndexType>
+{
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing a streaming simd access to a consecutive sequence of elements in an array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    using location_type = streaming_location<linear_location<T, SimdSize>>;
+    return value_access<location_type, sizeof(T)>(location_type{linear_location<T, SimdSize>{data + this->index_}});
+  }
+};
+
+/// Class representing a simd index to a consecutive sequence of elements, whose first element is aligned to the vector
+/// size.
+/**
+ * The index behaves like `index`, but consecutive elements of arithmetic type are loaded and stored by aligned vector
+ * accesses. Thus, the address of the element at `index_` must be aligned to the vector size for all arrays accessed by
+ * this index. Loops create this index for the policy `aligned_access`.
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam IndexType Type of the index.
+ */
+template<int SimdSize, class IndexType = size_t>
+struct aligned_index : index<SimdSize, IndexType>
+{
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing an aligned simd access to a consecutive sequence of elements in an array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    using location_type = aligned_location<linear_location<T, SimdSize>>;
+    return value_access<location_type, sizeof(T)>(location_type{linear_location<T, SimdSize>{data + this->index_}});
+  }
+};
+
+/// Class representing a simd index to a sequence of elements with a constant distance known at compile time, e.g. a
+/// column of a row-major matrix.
+/**
+ * Accesses via this index are accesses with a constant pitch of `Stride` elements. Small strides of arithmetic
+ * elements are loaded by vector loads and extracted by shuffle instructions (see `native_pitched_load`).
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam Stride Distance of the elements, must not be zero.
+ * @tparam IndexType Type of the index.
+ */
+template<int SimdSize, size_t Stride, class IndexType = size_t>
+struct strided_index
+{
+  static_assert(Stride > 0);
+
+  /// Return the length of the simd sequence.
+  /**
+   * @return The length of the simd sequence.
+   */
+  static constexpr int size() { return SimdSize; }
+
+  /// Return the distance of the elements.
+  static constexpr size_t stride() { return Stride; }
+
+  /// Return the scalar index of a vector lane.
+  /**
+   * @param i Index in the vector must be in the range [0, SimdSize) .
+   * @return The scalar index at vector lane i, i.e. index_ + i * Stride.
+   */
+  auto scalar_index(int i) const { return IndexType(index_ + IndexType(i) * IndexType(Stride)); }
+
+  /// The index of the first element.
+  IndexType index_;
+
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing a simd access expression to elements with a constant pitch in an array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    return value_access<linear_location<T, SimdSize>, sizeof(T) * Stride>(linear_location<T, SimdSize>{data + index_});
+  }
+
+  /// Transforms this to a simd value.
+  /**
+   * @return The value represented by this transformed to a simd value.
+   */
+  auto to_simd() const
+  {
+    return stdx::fixed_size_simd<IndexType, SimdSize>([this](auto i){ return scalar_index(i); });
+  }
+};
+
+/// Class representing a simd index to a sequence of elements with a constant distance known at runtime.
+/**
+ * Accesses via this index compute the offsets of the lanes from the stride and use native gather and scatter
+ * instructions, if available. No index array is stored in memory.
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam IndexType Type of the index and of the stride.
+ */
+template<int SimdSize, class IndexType = size_t>
+struct runtime_strided_index
+{
+  /// Return the length of the simd sequence.
+  /**
+   * @return The length of the simd sequence.
+   */
+  static constexpr int size() { return SimdSize; }
+
+  /// Return the scalar index of a vector lane.
+  /**
+   * @param i Index in the vector must be in the range [0, SimdSize) .
+   * @return The scalar index at vector lane i, i.e. index_ + i * stride_.
+   */
+  auto scalar_index(int i) const { return IndexType(index_ + IndexType(i) * stride_); }
+
+  /// Return the distance of the elements.
+  IndexType stride() const { return stride_; }
+
+  /// The index of the first element.
+  IndexType index_;
+
+  /// The distance of the elements, must not be zero for stores.
+  IndexType stride_;
+
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing a simd access expression to elements with a constant pitch in an array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    using location_type = strided_location<T, SimdSize, IndexType>;
+    return value_access<location_type, sizeof(T)>(location_type{data + index_, stride_});
+  }
+
+  /// Transforms this to a simd value.
+  /**
+   * @return The value represented by this transformed to a simd value.
+   */
+  auto to_simd() const
+  {
+    return stdx::fixed_size_simd<IndexType, SimdSize>([this](auto i){ return scalar_index(i); });
+  }
+};
+
 
 /// Class representing a simd index to indirect indexed elements in an array.
 /**
@@ -105,13 +269,277 @@ struct index_array
   }
 };
 
+/// Class representing a simd index to a consecutive sequence of elements, of which only the active lanes of a mask
+/// are accessed.
+/**
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam IndexType Type of the index.
+ */
+template<int SimdSize, class IndexType = size_t>
+struct masked_index
+{
+  using mask_type = stdx::fixed_size_simd_mask<IndexType, SimdSize>;
+
+  /// Return the length of the simd sequence.
+  /**
+   * @return The length of the simd sequence.
+   */
+  static constexpr int size() { return SimdSize; }
+
+  /// Return the scalar index of a vector lane.
+  /**
+   * @param i Index in the vector must be in the range [0, SimdSize) .
+   * @return The scalar index at vector lane i, i.e. index_ + i.
+   */
+  auto scalar_index(int i) const { return index_ + IndexType(i); }
+
+  /// The index, at which the sequence starts.
+  IndexType index_;
+
+  /// The mask, whose active lanes are accessed.
+  mask_type mask_;
+
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing a masked simd access expression to a consecutive sequence of elements in an
+   *   array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    using location_type = masked_location<linear_location<T, SimdSize>, mask_type>;
+    return value_access<location_type, sizeof(T)>(location_type{linear_location<T, SimdSize>{data + index_}, mask_});
+  }
+
+  /// Transforms this to a simd value.
+  /**
+   * @return The value represented by this transformed to a simd value. Inactive lanes are included.
+   */
+  auto to_simd() const
+  {
+    return stdx::fixed_size_simd<IndexType, SimdSize>([this](auto i){ return IndexType(index_ + i); });
+  }
+};
+
+
+/// Class representing a simd index to indirect indexed elements in an array, of which only the active lanes of a mask
+/// are accessed.
+/**
+ * @tparam SimdSize Length of the simd sequence.
+ * @tparam ArrayType Type of the array, which stores the indices (see `index_array`). Entries of inactive lanes are
+ *   never read, thus the array may end before the inactive lanes.
+ */
+template<int SimdSize, class ArrayType = std::array<size_t, SimdSize>>
+struct masked_index_array
+{
+  using mask_type =
+    stdx::fixed_size_simd_mask<std::remove_cvref_t<decltype(std::declval<const ArrayType&>()[0])>, SimdSize>;
+
+  /// Return the length of the simd sequence.
+  /**
+   * @return The length of the simd sequence.
+   */
+  static constexpr int size() { return SimdSize; }
+
+  /// Return the scalar index of a vector lane.
+  /**
+   * @param i Index in the vector must be in the range [0, SimdSize) and the lane must be active.
+   * @return The scalar index at vector lane i, i.e. index_[i].
+   */
+  auto scalar_index(int i) const { return index_[i]; }
+
+  /// The index array, the n'th entry defines the index of the n'th element in the simd type.
+  ArrayType index_;
+
+  /// The mask, whose active lanes are accessed.
+  mask_type mask_;
+
+  /// A reverse overloaded operator[] for simdized array accesses, since global operator[] is not allowed (yet).
+  /**
+   * @tparam T Data type of the elements in the array.
+   * @param data Pointer to the array.
+   * @return A value_access representing a masked simd access expression to indirect indexed elements in an array.
+   */
+  template<class T>
+  auto operator[](T* data) const
+  {
+    using location_type = masked_location<indexed_location<T, SimdSize, ArrayType>, mask_type>;
+    return value_access<location_type, sizeof(T)>(
+      location_type{indexed_location<T, SimdSize, ArrayType>{data, index_}, mask_});
+  }
+};
+
+/// Class representing an index to a point or to a simd sequence of points in a multi-dimensional box, which is
+/// vectorized along the last (contiguous) dimension.
+/**
+ * Accesses via this index to a multi-dimensional array `base` (e.g. a nested C array or a `row_major_view`) access
+ * the row `base[outer_[0]]...[outer_[Rank - 2]]` by the index in the last dimension.
+ * @tparam Rank Number of dimensions.
+ * @tparam InnerIndexType Type of the index in the last dimension, either a simd index (`index`, `masked_index`) or an
+ *   integral index.
+ * @tparam IndexType Type of the indices in the outer dimensions.
+ */
+template<size_t Rank, class InnerIndexType, class IndexType = size_t>
+struct index_nd
+{
+  static_assert(Rank > 0);
+
+  /// Return the length of the simd sequence, 1 for an integral index in the last dimension.
+  static constexpr int size()
+  {
+    if constexpr (std::is_integral_v<InnerIndexType>)
+    {
+      return 1;
+    }
+    else
+    {
+      return InnerIndexType::size();
+    }
+  }
+
+  /// Return the row of a multi-dimensional array, which is accessed by this index.
+  /**
+   * @param base Multi-dimensional array in row-major order.
+   * @return The result of `base[outer_[0]]...[outer_[Rank - 2]]`. Rows returned by value (e.g. by `row_major_view`)
+   *   are returned by value.
+   */
+  template<size_t Dim = 0>
+  decltype(auto) row(auto&& base) const
+  {
+    if constexpr (Dim + 1 == Rank && std::is_lvalue_reference_v<decltype(base)>)
+    {
+      return (base);
+    }
+    else if constexpr (Dim + 1 == Rank)
+    {
+      return std::remove_cvref_t<decltype(base)>(std::move(base));
+    }
+    else
+    {
+      return row<Dim + 1>(base[outer_[Dim]]);
+    }
+  }
+
+  /// Return this index shifted in an outer dimension, e.g. to access the neighbours in a stencil.
+  /**
+   * @tparam Dim The outer dimension, must be smaller than `Rank - 1`.
+   * @param offset Number of rows, by which the index is shifted.
+   * @return The shifted index.
+   */
+  template<size_t Dim>
+  index_nd shifted(std::integral auto offset) const
+  {
+    static_assert(Dim + 1 < Rank, "the last dimension is shifted by operator+ and operator-");
+    index_nd result = *this;
+    result.outer_[Dim] += IndexType(offset);
+    return result;
+  }
+
+  /// The indices in the outer dimensions.
+  std::array<IndexType, Rank - 1> outer_;
+  /// The index in the last dimension.
+  InnerIndexType inner_;
+};
+
+/**
+ * Shifts a simd index to consecutive elements by an offset, e.g. to access the neighbours in a stencil by
+ * `SIMD_ACCESS(a, i + 1)`. Streaming and aligned indices are shifted to an `index`, since the shifted elements aren't
+ * aligned anymore. Masked indices keep their mask, strided indices their stride (i.e. the first element is shifted),
+ * an `index_nd` is shifted in its last dimension.
+ * @param idx Simd index.
+ * @param offset Number of elements, by which the index is shifted.
+ * @return The shifted index.
+ */
+template<int SimdSize, class IndexType>
+inline index<SimdSize, IndexType> operator+(const index<SimdSize, IndexType>& idx, std::integral auto offset)
+{
+  return {IndexType(idx.index_ + IndexType(offset))};
+}
+
+template<int SimdSize, class IndexType>
+inline index<SimdSize, IndexType> operator-(const index<SimdSize, IndexType>& idx, std::integral auto offset)
+{
+  return {IndexType(idx.index_ - IndexType(offset))};
+}
+
+template<int SimdSize, class IndexType>
+inline masked_index<SimdSize, IndexType> operator+(const masked_index<SimdSize, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ + IndexType(offset)), idx.mask_};
+}
+
+template<int SimdSize, class IndexType>
+inline masked_index<SimdSize, IndexType> operator-(const masked_index<SimdSize, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ - IndexType(offset)), idx.mask_};
+}
+
+template<int SimdSize, size_t Stride, class IndexType>
+inline strided_index<SimdSize, Stride, IndexType> operator+(const strided_index<SimdSize, Stride, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ + IndexType(offset))};
+}
+
+template<int SimdSize, size_t Stride, class IndexType>
+inline strided_index<SimdSize, Stride, IndexType> operator-(const strided_index<SimdSize, Stride, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ - IndexType(offset))};
+}
+
+template<int SimdSize, class IndexType>
+inline runtime_strided_index<SimdSize, IndexType> operator+(const runtime_strided_index<SimdSize, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ + IndexType(offset)), idx.stride_};
+}
+
+template<int SimdSize, class IndexType>
+inline runtime_strided_index<SimdSize, IndexType> operator-(const runtime_strided_index<SimdSize, IndexType>& idx,
+  std::integral auto offset)
+{
+  return {IndexType(idx.index_ - IndexType(offset)), idx.stride_};
+}
+
+template<size_t Rank, class InnerIndexType, class IndexType>
+inline auto operator+(const index_nd<Rank, InnerIndexType, IndexType>& idx, std::integral auto offset)
+{
+  auto inner = idx.inner_ + offset;
+  return index_nd<Rank, decltype(inner), IndexType>{idx.outer_, inner};
+}
+
+template<size_t Rank, class InnerIndexType, class IndexType>
+inline auto operator-(const index_nd<Rank, InnerIndexType, IndexType>& idx, std::integral auto offset)
+{
+  auto inner = idx.inner_ - offset;
+  return index_nd<Rank, decltype(inner), IndexType>{idx.outer_, inner};
+}
+
 template<class PotentialIndexType>
 concept is_index =
   (is_stdx_simd<PotentialIndexType> && std::is_integral_v<typename PotentialIndexType::value_type>) ||
   requires(PotentialIndexType x) { []<int SimdSize, class IndexType>(index<SimdSize, IndexType>&){}(x); } ||
-  requires(PotentialIndexType x) { []<int SimdSize, class ArrayType>(index_array<SimdSize, ArrayType>&){}(x); };
+  requires(PotentialIndexType x) { []<int SimdSize, size_t Stride, class IndexType>(
+    strided_index<SimdSize, Stride, IndexType>&){}(x); } ||
+  requires(PotentialIndexType x) {
+    []<int SimdSize, class IndexType>(runtime_strided_index<SimdSize, IndexType>&){}(x); } ||
+  requires(PotentialIndexType x) { []<int SimdSize, class ArrayType>(index_array<SimdSize, ArrayType>&){}(x); } ||
+  requires(PotentialIndexType x) { []<int SimdSize, class IndexType>(masked_index<SimdSize, IndexType>&){}(x); } ||
+  requires(PotentialIndexType x) { []<int SimdSize, class ArrayType>(masked_index_array<SimdSize, ArrayType>&){}(x); };
 
-/// TODO: Introduce masked_index and masked_index_array to support e.g. residual masked loops.
+/**
+ * Checks, whether a simd index accesses consecutive elements, i.e. whether it is an `index` (or derived from it) or a
+ * `masked_index`.
+ */
+template<class PotentialIndexType>
+concept is_linear_index =
+  requires(PotentialIndexType x) { []<int SimdSize, class IndexType>(const index<SimdSize, IndexType>&){}(x); } ||
+  requires(PotentialIndexType x) { []<int SimdSize, class IndexType>(const masked_index<SimdSize, IndexType>&){}(x); };
 
 template<int SimdSize, class IndexType>
 inline auto get_index(const index<SimdSize, IndexType>& idx, auto i)
@@ -119,6 +547,18 @@ inline auto get_index(const index<SimdSize, IndexType>& idx, auto i)
   return idx.index_ + i;
 }
 
+template<int SimdSize, size_t Stride, class IndexType>
+inline auto get_index(const strided_index<SimdSize, Stride, IndexType>& idx, auto i)
+{
+  return idx.scalar_index(i);
+}
+
+template<int SimdSize, class IndexType>
+inline auto get_index(const runtime_strided_index<SimdSize, IndexType>& idx, auto i)
+{
+  return idx.scalar_index(i);
+}
+
 template<int SimdSize, class ArrayType>
 inline auto get_index(const index_array<SimdSize, ArrayType>& idx, auto i)
 {
@@ -131,6 +571,96 @@ inline auto get_index(const stdx::simd<IndexType, Abi>& idx, auto i)
   return idx[i];
 }
 
+template<int SimdSize, class IndexType>
+inline auto get_index(const masked_index<SimdSize, IndexType>& idx, auto i)
+{
+  return idx.index_ + i;
+}
+
+template<int SimdSize, class ArrayType>
+inline auto get_index(const masked_index_array<SimdSize, ArrayType>& idx, auto i)
+{
+  return idx.scalar_index(i);
+}
+
+/**
+ * Checks, whether a lane of a simd index is accessed. Only lanes of masked indices might be inactive.
+ * @param idx Simd index.
+ * @param i Lane of the index.
+ * @return True, if the lane is active.
+ */
+inline bool is_active_lane(const auto&, auto)
+{
+  return true;
+}
+
+template<int SimdSize, class IndexType>
+inline bool is_active_lane(const masked_index<SimdSize, IndexType>& idx, auto i)
+{
+  return idx.mask_[i];
+}
+
+template<int SimdSize, class ArrayType>
+inline bool is_active_lane(const masked_index_array<SimdSize, ArrayType>& idx, auto i)
+{
+  return idx.mask_[i];
+}
+
+/**
+ * Restricts a simd index to the active lanes of a simd mask.
+ * @param idx Simd index.
+ * @param mask Simd mask.
+ * @return A masked index, whose active lanes are the active lanes of `mask` (and of `idx`, if it is masked).
+ */
+template<int SimdSize, class IndexType>
+inline auto make_masked_index(const index<SimdSize, IndexType>& idx, const auto& mask)
+{
+  using result_type = masked_index<SimdSize, IndexType>;
+  return result_type{idx.index_, typename result_type::mask_type(mask)};
+}
+
+template<int SimdSize, class IndexType>
+inline auto make_masked_index(const masked_index<SimdSize, IndexType>& idx, const auto& mask)
+{
+  using result_type = masked_index<SimdSize, IndexType>;
+  return result_type{idx.index_, idx.mask_ && typename result_type::mask_type(mask)};
+}
+
+template<int SimdSize, size_t Stride, class IndexType>
+inline auto make_masked_index(const strided_index<SimdSize, Stride, IndexType>& idx, const auto& mask)
+{
+  using result_type = masked_index_array<SimdSize, stdx::fixed_size_simd<IndexType, SimdSize>>;
+  return result_type{idx.to_simd(), typename result_type::mask_type(mask)};
+}
+
+template<int SimdSize, class IndexType>
+inline auto make_masked_index(const runtime_strided_index<SimdSize, IndexType>& idx, const auto& mask)
+{
+  using result_type = masked_index_array<SimdSize, stdx::fixed_size_simd<IndexType, SimdSize>>;
+  return result_type{idx.to_simd(), typename result_type::mask_type(mask)};
+}
+
+template<int SimdSize, class ArrayType>
+inline auto make_masked_index(const index_array<SimdSize, ArrayType>& idx, const auto& mask)
+{
+  using result_type = masked_index_array<SimdSize, ArrayType>;
+  return result_type{idx.index_, typename result_type::mask_type(mask)};
+}
+
+template<int SimdSize, class ArrayType>
+inline auto make_masked_index(const masked_index_array<SimdSize, ArrayType>& idx, const auto& mask)
+{
+  using result_type = masked_index_array<SimdSize, ArrayType>;
+  return result_type{idx.index_, idx.mask_ && typename result_type::mask_type(mask)};
+}
+
+template<class IndexType, class Abi>
+inline auto make_masked_index(const stdx::simd<IndexType, Abi>& idx, const auto& mask)
+{
+  using result_type = masked_index_array<int(stdx::simd<IndexType, Abi>::size()), stdx::simd<IndexType, Abi>>;
+  return result_type{idx, typename result_type::mask_type(mask)};
+}
+
 } //namespace simd_access
 
 #endif //SIMD_ACCESS_INDEX
@@ -0,0 +1,948 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Wrappers of architecture specific simd instructions used by the load and store functions.
+ *
+ * The functions return nothing (i.e. `void`), if there is no native instruction available for a given combination
+ * of element type and vector size. Callers check this at compile time and fall back to their portable
+ * implementations.
+ */
+
+#ifndef SIMD_ACCESS_INTRINSICS
+#define SIMD_ACCESS_INTRINSICS
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include "simd_access/base.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace simd_access
+{
+
+/**
+ * Converts a native vector type (e.g. `__m256d`) to a `stdx::fixed_size_simd`. If the native type is larger than
+ * the simd type, the lower part of the native vector is used. The conversion is optimized away by the compiler.
+ * @tparam SimdType Type of the result.
+ * @param x Native vector.
+ * @return A simd value with the bit pattern of (the lower part of) `x`.
+ */
+template<class SimdType, class NativeType>
+inline SimdType from_native(const NativeType& x)
+{
+  static_assert(sizeof(typename SimdType::value_type) * SimdType::size() <= sizeof(NativeType));
+  alignas(NativeType) typename SimdType::value_type buffer[sizeof(NativeType) / sizeof(typename SimdType::value_type)];
+  std::memcpy(buffer, &x, sizeof(x));
+  return SimdType(buffer, stdx::element_aligned);
+}
+
+/**
+ * Converts a `stdx::fixed_size_simd` to a native vector type (e.g. `__m128i`). If the native type is larger than
+ * the simd type, the upper part of the native vector is zeroed. The conversion is optimized away by the compiler.
+ * @tparam NativeType Type of the result.
+ * @param x Simd value.
+ * @return A native vector with the bit pattern of `x` in its lower part.
+ */
+template<class NativeType, class T, int SimdSize>
+inline NativeType to_native(const stdx::fixed_size_simd<T, SimdSize>& x)
+{
+  static_assert(sizeof(T) * SimdSize <= sizeof(NativeType));
+  alignas(NativeType) T buffer[sizeof(NativeType) / sizeof(T)] = {};
+  x.copy_to(buffer, stdx::element_aligned);
+  NativeType result;
+  std::memcpy(&result, buffer, sizeof(result));
+  return result;
+}
+
+/// Unsigned integer type of `Size` bytes, which is used to handle elements regardless of their type.
+template<size_t Size>
+using bits_type =
+  std::conditional_t<Size == 1, std::uint8_t,
+    std::conditional_t<Size == 2, std::uint16_t,
+      std::conditional_t<Size == 4, std::uint32_t,
+        std::conditional_t<Size == 8, std::uint64_t, void>>>>;
+
+/**
+ * Converts a simd mask to a native mask, which is either an integral bit mask (e.g. `__mmask8`) or a vector type
+ * (e.g. `__m256d`), whose lanes have all bits set for active lanes.
+ * @tparam NativeType Type of the result.
+ * @param mask Simd mask.
+ * @return The native mask.
+ */
+template<class NativeType, class T, int SimdSize>
+inline NativeType to_native_mask(const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  if constexpr (std::is_integral_v<NativeType>)
+  {
+    static_assert(SimdSize <= 8 * sizeof(NativeType));
+    NativeType result = 0;
+    for (int i = 0; i < SimdSize; ++i)
+    {
+      result |= NativeType(NativeType(mask[i]) << i);
+    }
+    return result;
+  }
+  else
+  {
+    using LaneType = stdx::fixed_size_simd<bits_type<sizeof(T)>, SimdSize>;
+    LaneType lanes = 0;
+    stdx::where(typename LaneType::mask_type(mask), lanes) = LaneType(~bits_type<sizeof(T)>(0));
+    return to_native<NativeType>(lanes);
+  }
+}
+
+/**
+ * Splits a simd mask into two halves.
+ * @param mask Simd mask.
+ * @return A pair of the lower and upper half of the mask.
+ */
+template<class T, int SimdSize>
+inline auto split_mask(const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  using HalfMaskType = stdx::fixed_size_simd_mask<T, SimdSize / 2>;
+  bool lanes[SimdSize];
+  mask.copy_to(lanes, stdx::element_aligned);
+  return std::make_pair(HalfMaskType(lanes, stdx::element_aligned),
+    HalfMaskType(lanes + SimdSize / 2, stdx::element_aligned));
+}
+
+/**
+ * Gathers the active lanes of `SimdSize` elements of size `sizeof(T)` from the addresses `base + Scale * indices[i]`
+ * using a native gather instruction. Only 32- and 64-bit element types are supported. The elements are loaded
+ * bitwise, thus the instruction for floating point types is also used for integral types of the same size.
+ * Inactive lanes are neither loaded nor is their memory touched, they are zero in the result.
+ * @tparam Scale Scale factor of the indices, must be 1, 2, 4 or 8.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @tparam IndexType Type of the indices, must be `int32_t` or `int64_t`.
+ * @param base Base address.
+ * @param indices Indices of the elements.
+ * @param mask Mask of the active lanes.
+ * @return The gathered simd value or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<int Scale, class T, int SimdSize, class IndexType>
+inline auto native_scaled_gather([[maybe_unused]] const T* base,
+  [[maybe_unused]] const stdx::fixed_size_simd<IndexType, SimdSize>& indices,
+  [[maybe_unused]] const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  using ResultType = stdx::fixed_size_simd<T, SimdSize>;
+  constexpr bool is_index32 = std::is_same_v<IndexType, std::int32_t>;
+  constexpr bool is_index64 = std::is_same_v<IndexType, std::int64_t>;
+  [[maybe_unused]] auto base64 = reinterpret_cast<const double*>(base);
+  [[maybe_unused]] auto base32 = reinterpret_cast<const float*>(base);
+  static_assert(Scale == 1 || Scale == 2 || Scale == 4 || Scale == 8);
+#if defined(__AVX512F__)
+  if constexpr (sizeof(T) == 8 && SimdSize == 8 && is_index32)
+  {
+    return from_native<ResultType>(_mm512_mask_i32gather_pd(_mm512_setzero_pd(), to_native_mask<__mmask8>(mask),
+      to_native<__m256i>(indices), base64, Scale));
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 8 && is_index64)
+  {
+    return from_native<ResultType>(_mm512_mask_i64gather_pd(_mm512_setzero_pd(), to_native_mask<__mmask8>(mask),
+      to_native<__m512i>(indices), base64, Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 16 && is_index32)
+  {
+    return from_native<ResultType>(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), to_native_mask<__mmask16>(mask),
+      to_native<__m512i>(indices), base32, Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 8 && is_index64)
+  {
+    return from_native<ResultType>(_mm512_mask_i64gather_ps(_mm256_setzero_ps(), to_native_mask<__mmask8>(mask),
+      to_native<__m512i>(indices), base32, Scale));
+  }
+  else
+#endif
+#if defined(__AVX2__)
+  if constexpr (sizeof(T) == 8 && SimdSize == 2 && is_index32)
+  {
+    return from_native<ResultType>(_mm_mask_i32gather_pd(_mm_setzero_pd(), base64, to_native<__m128i>(indices),
+      to_native_mask<__m128d>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 2 && is_index64)
+  {
+    return from_native<ResultType>(_mm_mask_i64gather_pd(_mm_setzero_pd(), base64, to_native<__m128i>(indices),
+      to_native_mask<__m128d>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 4 && is_index32)
+  {
+    return from_native<ResultType>(_mm256_mask_i32gather_pd(_mm256_setzero_pd(), base64,
+      to_native<__m128i>(indices), to_native_mask<__m256d>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 4 && is_index64)
+  {
+    return from_native<ResultType>(_mm256_mask_i64gather_pd(_mm256_setzero_pd(), base64,
+      to_native<__m256i>(indices), to_native_mask<__m256d>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 4 && is_index32)
+  {
+    return from_native<ResultType>(_mm_mask_i32gather_ps(_mm_setzero_ps(), base32, to_native<__m128i>(indices),
+      to_native_mask<__m128>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 8 && is_index32)
+  {
+    return from_native<ResultType>(_mm256_mask_i32gather_ps(_mm256_setzero_ps(), base32,
+      to_native<__m256i>(indices), to_native_mask<__m256>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 2 && is_index64)
+  {
+    return from_native<ResultType>(_mm_mask_i64gather_ps(_mm_setzero_ps(), base32, to_native<__m128i>(indices),
+      to_native_mask<__m128>(mask), Scale));
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 4 && is_index64)
+  {
+    return from_native<ResultType>(_mm256_mask_i64gather_ps(_mm_setzero_ps(), base32, to_native<__m256i>(indices),
+      to_native_mask<__m128>(mask), Scale));
+  }
+  else
+#endif
+  if constexpr (SimdSize > 2 && SimdSize % 2 == 0)
+  {
+    // split vectors, which are wider than the native ones
+    constexpr int HalfSize = SimdSize / 2;
+    using HalfIndexType = stdx::fixed_size_simd<IndexType, HalfSize>;
+    using HalfMaskType = stdx::fixed_size_simd_mask<T, HalfSize>;
+    if constexpr (!std::is_void_v<decltype(native_scaled_gather<Scale>(base, std::declval<HalfIndexType>(),
+                                                                       std::declval<HalfMaskType>()))>)
+    {
+      auto [lower_mask, upper_mask] = split_mask(mask);
+      alignas(ResultType) T buffer[SimdSize];
+      native_scaled_gather<Scale>(base, HalfIndexType([&](int i) { return indices[i]; }), lower_mask)
+        .copy_to(buffer, stdx::element_aligned);
+      native_scaled_gather<Scale>(base, HalfIndexType([&](int i) { return indices[i + HalfSize]; }), upper_mask)
+        .copy_to(buffer + HalfSize, stdx::element_aligned);
+      return ResultType(buffer, stdx::element_aligned);
+    }
+  }
+}
+
+/**
+ * Scatters the active lanes of `SimdSize` elements of size `sizeof(T)` to the addresses `base + Scale * indices[i]`
+ * using a native scatter instruction, which is only available with AVX-512. Lanes with equal addresses are written
+ * in ascending order. Only 32- and 64-bit element types are supported.
+ * @tparam Scale Scale factor of the indices, must be 1, 2, 4 or 8.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @tparam IndexType Type of the indices, must be `int32_t` or `int64_t`.
+ * @param base Base address.
+ * @param indices Indices of the elements.
+ * @param source Simd value to be stored.
+ * @param mask Mask of the active lanes.
+ * @return `true` or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<int Scale, class T, int SimdSize, class IndexType>
+inline auto native_scaled_scatter([[maybe_unused]] T* base,
+  [[maybe_unused]] const stdx::fixed_size_simd<IndexType, SimdSize>& indices,
+  [[maybe_unused]] const stdx::fixed_size_simd<T, SimdSize>& source,
+  [[maybe_unused]] const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  constexpr bool is_index32 = std::is_same_v<IndexType, std::int32_t>;
+  constexpr bool is_index64 = std::is_same_v<IndexType, std::int64_t>;
+  static_assert(Scale == 1 || Scale == 2 || Scale == 4 || Scale == 8);
+#if defined(__AVX512F__)
+  if constexpr (sizeof(T) == 8 && SimdSize == 8 && is_index32)
+  {
+    _mm512_mask_i32scatter_pd(base, to_native_mask<__mmask8>(mask), to_native<__m256i>(indices),
+      to_native<__m512d>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 8 && is_index64)
+  {
+    _mm512_mask_i64scatter_pd(base, to_native_mask<__mmask8>(mask), to_native<__m512i>(indices),
+      to_native<__m512d>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 16 && is_index32)
+  {
+    _mm512_mask_i32scatter_ps(base, to_native_mask<__mmask16>(mask), to_native<__m512i>(indices),
+      to_native<__m512>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 8 && is_index64)
+  {
+    _mm512_mask_i64scatter_ps(base, to_native_mask<__mmask8>(mask), to_native<__m512i>(indices),
+      to_native<__m256>(source), Scale);
+    return true;
+  }
+  else
+#endif
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+  if constexpr (sizeof(T) == 8 && SimdSize == 4 && is_index32)
+  {
+    _mm256_mask_i32scatter_pd(base, to_native_mask<__mmask8>(mask), to_native<__m128i>(indices),
+      to_native<__m256d>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 8 && SimdSize == 4 && is_index64)
+  {
+    _mm256_mask_i64scatter_pd(base, to_native_mask<__mmask8>(mask), to_native<__m256i>(indices),
+      to_native<__m256d>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 8 && is_index32)
+  {
+    _mm256_mask_i32scatter_ps(base, to_native_mask<__mmask8>(mask), to_native<__m256i>(indices),
+      to_native<__m256>(source), Scale);
+    return true;
+  }
+  else if constexpr (sizeof(T) == 4 && SimdSize == 4 && is_index64)
+  {
+    _mm256_mask_i64scatter_ps(base, to_native_mask<__mmask8>(mask), to_native<__m256i>(indices),
+      to_native<__m128>(source), Scale);
+    return true;
+  }
+  else
+#endif
+  if constexpr (SimdSize > 2 && SimdSize % 2 == 0)
+  {
+    // split vectors, which are wider than the native ones
+    constexpr int HalfSize = SimdSize / 2;
+    using HalfIndexType = stdx::fixed_size_simd<IndexType, HalfSize>;
+    using HalfSourceType = stdx::fixed_size_simd<T, HalfSize>;
+    using HalfMaskType = stdx::fixed_size_simd_mask<T, HalfSize>;
+    if constexpr (!std::is_void_v<decltype(native_scaled_scatter<Scale>(base, std::declval<HalfIndexType>(),
+                                                                        std::declval<HalfSourceType>(),
+                                                                        std::declval<HalfMaskType>()))>)
+    {
+      auto [lower_mask, upper_mask] = split_mask(mask);
+      native_scaled_scatter<Scale>(base, HalfIndexType([&](int i) { return indices[i]; }),
+        HalfSourceType([&](int i) { return source[i]; }), lower_mask);
+      native_scaled_scatter<Scale>(base, HalfIndexType([&](int i) { return indices[i + HalfSize]; }),
+        HalfSourceType([&](int i) { return source[i + HalfSize]; }), upper_mask);
+      return true;
+    }
+  }
+}
+
+/**
+ * Determines the scale and the index type of a native gather of elements of `ElementSize` bytes. Scales are
+ * restricted to 1, 2, 4 and 8 by the hardware. Other element sizes are handled by scaling the indices in advance,
+ * in which case 64 bit indices are used to avoid overflows. Unsigned 32 bit indices are extended to 64 bit too,
+ * since the gather instructions treat indices as signed.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam IndexType Type of the indices as stored in the index array.
+ */
+template<size_t ElementSize, class IndexType>
+struct gather_traits
+{
+  static constexpr int scale = ElementSize % 8 == 0 ? 8 : ElementSize % 4 == 0 ? 4 : ElementSize % 2 == 0 ? 2 : 1;
+  static constexpr size_t index_factor = ElementSize / scale;
+  static constexpr bool is_small_index =
+    sizeof(IndexType) < 4 || (sizeof(IndexType) == 4 && std::is_signed_v<IndexType>);
+  using native_index_type = std::conditional_t<is_small_index && index_factor == 1, std::int32_t, std::int64_t>;
+};
+
+/**
+ * Converts the indices of elements of `ElementSize` bytes to the indices passed to a native gather or scatter
+ * instruction with the scale `gather_traits::scale`.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param indices Indices of the elements.
+ * @return The native indices.
+ */
+template<size_t ElementSize, class IndexType, int SimdSize>
+inline auto native_indices(const stdx::fixed_size_simd<IndexType, SimdSize>& indices)
+{
+  using traits = gather_traits<ElementSize, IndexType>;
+  using NativeIndexType = typename traits::native_index_type;
+  auto result = stdx::static_simd_cast<stdx::fixed_size_simd<NativeIndexType, SimdSize>>(indices);
+  if constexpr (traits::index_factor != 1)
+  {
+    result *= NativeIndexType(traits::index_factor);
+  }
+  return result;
+}
+
+/**
+ * Gathers the active lanes of elements from the addresses `base + ElementSize * indices[i]` using a native gather
+ * instruction. Inactive lanes are zero in the result.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Element type.
+ * @tparam IndexType Type of the indices.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Base address.
+ * @param indices Indices of the elements.
+ * @param mask Mask of the active lanes.
+ * @return The gathered simd value or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<size_t ElementSize, class T, class IndexType, int SimdSize>
+inline auto native_gather(const T* base, const stdx::fixed_size_simd<IndexType, SimdSize>& indices,
+  const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  return native_scaled_gather<gather_traits<ElementSize, IndexType>::scale>(base,
+    native_indices<ElementSize>(indices), mask);
+}
+
+/**
+ * Gathers elements from the addresses `base + ElementSize * indices[i]` using a native gather instruction.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Element type.
+ * @tparam IndexType Type of the indices.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Base address.
+ * @param indices Indices of the elements.
+ * @return The gathered simd value or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<size_t ElementSize, class T, class IndexType, int SimdSize>
+inline auto native_gather(const T* base, const stdx::fixed_size_simd<IndexType, SimdSize>& indices)
+{
+  return native_gather<ElementSize>(base, indices, stdx::fixed_size_simd_mask<T, SimdSize>(true));
+}
+
+/**
+ * Checks, whether elements of type `T` with indices of type `IndexType` can be gathered by a native instruction.
+ */
+template<size_t ElementSize, class T, class IndexType, int SimdSize>
+concept has_native_gather =
+  std::is_integral_v<IndexType> &&
+  !std::is_void_v<decltype(native_gather<ElementSize>(std::declval<const T*>(),
+    std::declval<stdx::fixed_size_simd<IndexType, SimdSize>>()))>;
+
+/**
+ * Scatters the active lanes of a simd value to the addresses `base + ElementSize * indices[i]` using a native
+ * scatter instruction.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Element type.
+ * @tparam IndexType Type of the indices.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Base address.
+ * @param indices Indices of the elements.
+ * @param source Simd value to be stored.
+ * @param mask Mask of the active lanes.
+ * @return `true` or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<size_t ElementSize, class T, class IndexType, int SimdSize>
+inline auto native_scatter(T* base, const stdx::fixed_size_simd<IndexType, SimdSize>& indices,
+  const stdx::fixed_size_simd<T, SimdSize>& source, const stdx::fixed_size_simd_mask<T, SimdSize>& mask)
+{
+  return native_scaled_scatter<gather_traits<ElementSize, IndexType>::scale>(base,
+    native_indices<ElementSize>(indices), source, mask);
+}
+
+/**
+ * Checks, whether elements of type `T` with indices of type `IndexType` can be scattered by a native instruction.
+ */
+template<size_t ElementSize, class T, class IndexType, int SimdSize>
+concept has_native_scatter =
+  std::is_integral_v<IndexType> &&
+  !std::is_void_v<decltype(native_scatter<ElementSize>(std::declval<T*>(),
+    std::declval<stdx::fixed_size_simd<IndexType, SimdSize>>(), std::declval<stdx::fixed_size_simd<T, SimdSize>>(),
+    std::declval<stdx::fixed_size_simd_mask<T, SimdSize>>()))>;
+
+/**
+ * Detects for every lane the preceding lanes with equal values using the AVX-512CD conflict detection instruction.
+ * Only 32- and 64-bit integral types are supported.
+ * @tparam IndexType Type of the values.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param values Simd value, e.g. the indices of a scatter.
+ * @return A simd value, whose lane i has bit k set, if k < i and `values[k] == values[i]`, or nothing (i.e. `void`),
+ *   if there is no native instruction available.
+ */
+template<class IndexType, int SimdSize>
+inline auto native_conflict([[maybe_unused]] const stdx::fixed_size_simd<IndexType, SimdSize>& values)
+{
+  using ResultType = stdx::fixed_size_simd<IndexType, SimdSize>;
+  constexpr bool is_integral = std::is_integral_v<IndexType>;
+#if defined(__AVX512CD__)
+  if constexpr (is_integral && sizeof(IndexType) == 4 && SimdSize == 16)
+  {
+    return from_native<ResultType>(_mm512_conflict_epi32(to_native<__m512i>(values)));
+  }
+  else if constexpr (is_integral && sizeof(IndexType) == 8 && SimdSize == 8)
+  {
+    return from_native<ResultType>(_mm512_conflict_epi64(to_native<__m512i>(values)));
+  }
+  else
+#endif
+#if defined(__AVX512CD__) && defined(__AVX512VL__)
+  if constexpr (is_integral && sizeof(IndexType) == 4 && SimdSize == 8)
+  {
+    return from_native<ResultType>(_mm256_conflict_epi32(to_native<__m256i>(values)));
+  }
+  else if constexpr (is_integral && sizeof(IndexType) == 4 && SimdSize == 4)
+  {
+    return from_native<ResultType>(_mm_conflict_epi32(to_native<__m128i>(values)));
+  }
+  else if constexpr (is_integral && sizeof(IndexType) == 8 && SimdSize == 4)
+  {
+    return from_native<ResultType>(_mm256_conflict_epi64(to_native<__m256i>(values)));
+  }
+  else if constexpr (is_integral && sizeof(IndexType) == 8 && SimdSize == 2)
+  {
+    return from_native<ResultType>(_mm_conflict_epi64(to_native<__m128i>(values)));
+  }
+  else
+#endif
+  {
+    return;
+  }
+}
+
+/**
+ * Checks, whether conflicts of values of type `IndexType` can be detected by a native instruction.
+ */
+template<class IndexType, int SimdSize>
+concept has_native_conflict =
+  !std::is_void_v<decltype(native_conflict(std::declval<stdx::fixed_size_simd<IndexType, SimdSize>>()))>;
+
+/**
+ * Stores a simd value by a native non-temporal store, which bypasses the cache hierarchy. Only full native vectors
+ * (16, 32 or 64 bytes) are supported.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Address of the first element, must be aligned to `sizeof(T) * SimdSize`.
+ * @param source Simd value to be stored.
+ * @return `true` or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<class T, int SimdSize>
+inline auto native_stream_store([[maybe_unused]] T* base,
+  [[maybe_unused]] const stdx::fixed_size_simd<T, SimdSize>& source)
+{
+  [[maybe_unused]] constexpr size_t size = sizeof(T) * SimdSize;
+#if defined(__AVX512F__)
+  if constexpr (size == 64)
+  {
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(base), to_native<__m512i>(source));
+    return true;
+  }
+  else
+#endif
+#if defined(__AVX__)
+  if constexpr (size == 32)
+  {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(base), to_native<__m256i>(source));
+    return true;
+  }
+  else
+#endif
+#if defined(__SSE2__)
+  if constexpr (size == 16)
+  {
+    _mm_stream_si128(reinterpret_cast<__m128i*>(base), to_native<__m128i>(source));
+    return true;
+  }
+  else
+#endif
+  {
+    return;
+  }
+}
+
+/**
+ * Checks, whether simd values of type `T` can be stored by a native non-temporal store.
+ */
+template<class T, int SimdSize>
+concept has_native_stream_store =
+  !std::is_void_v<decltype(native_stream_store(std::declval<T*>(),
+    std::declval<stdx::fixed_size_simd<T, SimdSize>>()))>;
+
+/**
+ * Orders preceding non-temporal stores before all subsequent stores. Must be called after a sequence of
+ * non-temporal stores, before the written data is handed over to another thread.
+ */
+inline void native_stream_fence()
+{
+#if defined(__SSE__)
+  _mm_sfence();
+#endif
+}
+
+/// Vector type of the gcc vector extension with `SimdSize` elements of type `T`.
+template<class T, int SimdSize>
+struct vector_extension
+{
+  using type [[gnu::vector_size(sizeof(T) * SimdSize)]] = T;
+};
+
+template<class T, int SimdSize>
+using vector_extension_t = typename vector_extension<T, SimdSize>::type;
+
+/// Unaligned vector type of the gcc vector extension used for loads and stores of `SimdSize` elements of type `T`.
+template<class T, int SimdSize>
+struct unaligned_vector_extension
+{
+  using type [[gnu::vector_size(sizeof(T) * SimdSize), gnu::aligned(alignof(T)), gnu::may_alias]] = T;
+};
+
+/**
+ * Assembles a vector from the lanes of several source vectors using a sequence of two-operand shuffles.
+ * Only source vectors, which contribute to the result, are shuffled.
+ * @tparam Mapping Class with the static constexpr functions `source(lane)` and `position(lane)`, which return the
+ *   number of the source vector and the lane in the source vector for each lane of the result.
+ * @tparam SimdSize Number of elements of a vector.
+ * @tparam SourceCount Number of source vectors.
+ */
+template<class Mapping, int SimdSize, int SourceCount>
+struct lane_shuffle
+{
+  struct used_sources
+  {
+    std::array<int, SourceCount> source_{};
+    int count_ = 0;
+
+    constexpr int rank(int source) const
+    {
+      return int(std::find(source_.begin(), source_.begin() + count_, source) - source_.begin());
+    }
+  };
+
+  /// The contributing source vectors in the order of their first appearance in the result.
+  static constexpr used_sources used = []()
+    {
+      used_sources result;
+      for (int lane = 0; lane < SimdSize; ++lane)
+      {
+        if (result.rank(Mapping::source(lane)) == result.count_)
+        {
+          result.source_[result.count_++] = Mapping::source(lane);
+        }
+      }
+      return result;
+    } ();
+
+  /**
+   * Returns the shuffle index of a lane in a shuffle step. Step 0 merges the first two contributing source vectors
+   * (or permutes the only one), step n merges the contributing source vector n+1 into the result so far.
+   */
+  static constexpr int index(int step, int lane)
+  {
+    const int rank = used.rank(Mapping::source(lane));
+    const int position = Mapping::position(lane);
+    if (used.count_ == 1 || (step == 0 && rank == 0))
+    {
+      return position;
+    }
+    return rank == step + 1 ? SimdSize + position : (rank <= step ? lane : -1);
+  }
+
+  template<int Step, class VectorType, int... Lane>
+  static VectorType step(const VectorType& x, const VectorType& y, std::integer_sequence<int, Lane...>)
+  {
+    return VectorType(__builtin_shufflevector(x, y, index(Step, Lane)...));
+  }
+
+  /**
+   * Assembles the result vector.
+   * @param sources The source vectors.
+   * @return The result vector.
+   */
+  template<class VectorType>
+  static VectorType apply(const std::array<VectorType, SourceCount>& sources)
+  {
+    constexpr auto lanes = std::make_integer_sequence<int, SimdSize>();
+    if constexpr (used.count_ == 1)
+    {
+      return step<0>(sources[used.source_[0]], sources[used.source_[0]], lanes);
+    }
+    else
+    {
+      auto result = step<0>(sources[used.source_[0]], sources[used.source_[1]], lanes);
+      [&]<int... Step>(std::integer_sequence<int, Step...>)
+        {
+          ((result = step<Step + 1>(result, sources[used.source_[Step + 2]], lanes)), ...);
+        } (std::make_integer_sequence<int, used.count_ - 2>());
+      return result;
+    }
+  }
+};
+
+/**
+ * Describes a block of `ElementCount` consecutive elements, which is covered by vectors of `SimdSize` elements.
+ * All vectors are located inside the block, thus the last vector might overlap its predecessor.
+ * @tparam SimdSize Number of elements of a vector.
+ * @tparam ElementCount Number of elements of the block, must not be smaller than `SimdSize`.
+ */
+template<int SimdSize, int ElementCount>
+struct vector_block
+{
+  static_assert(ElementCount >= SimdSize);
+
+  /// Number of vectors covering the block.
+  static constexpr int vector_count = (ElementCount + SimdSize - 1) / SimdSize;
+
+  /// Returns the offset of the first element of vector `v` in the block.
+  static constexpr int vector_offset(int v) { return std::min(v * SimdSize, ElementCount - SimdSize); }
+
+  /// Returns the number of the first vector containing element `e` of the block.
+  static constexpr int vector_of(int e)
+  {
+    int v = 0;
+    while (e >= vector_offset(v) + SimdSize)
+    {
+      ++v;
+    }
+    return v;
+  }
+
+  /// Mapping of the lanes of a vector containing the elements `Offset + lane * Pitch` to the vectors of the block.
+  template<int Pitch, int Offset>
+  struct pitched_mapping
+  {
+    static constexpr int source(int lane) { return vector_of(Offset + lane * Pitch); }
+    static constexpr int position(int lane) { return Offset + lane * Pitch - vector_offset(source(lane)); }
+  };
+
+  /// Mapping of the lanes of vector `V` of the block to the vectors containing the pitched elements.
+  template<int Pitch, int V>
+  struct interleaved_mapping
+  {
+    static constexpr int source(int lane) { return (vector_offset(V) + lane) % Pitch; }
+    static constexpr int position(int lane) { return (vector_offset(V) + lane) / Pitch; }
+  };
+
+  /**
+   * Loads the vectors covering the block.
+   * @param base Address of the first element of the block.
+   * @return The vectors covering the block.
+   */
+  template<class T>
+  static auto load(const T* base)
+  {
+    using unaligned_type = typename unaligned_vector_extension<T, SimdSize>::type;
+    return [&]<int... V>(std::integer_sequence<int, V...>)
+      {
+        return std::array<vector_extension_t<T, SimdSize>, vector_count>{
+          *reinterpret_cast<const unaligned_type*>(base + vector_offset(V))... };
+      } (std::make_integer_sequence<int, vector_count>());
+  }
+
+  /**
+   * Extracts the elements `Offset`, `Offset + Pitch`, `Offset + 2 * Pitch`, ... of the block into a vector.
+   * @param vectors The vectors covering the block as returned by `load`.
+   * @return Vector of the extracted elements.
+   */
+  template<int Pitch, int Offset, class VectorType>
+  static VectorType extract(const std::array<VectorType, vector_count>& vectors)
+  {
+    return lane_shuffle<pitched_mapping<Pitch, Offset>, SimdSize, vector_count>::apply(vectors);
+  }
+
+  /**
+   * Interleaves `Pitch` vectors and stores them to the block, i.e. element `e` of the block is set to lane
+   * `e / Pitch` of vector `e % Pitch`. The block must contain `Pitch * SimdSize` elements.
+   * @param base Address of the first element of the block.
+   * @param vectors The vectors to be interleaved.
+   */
+  template<int Pitch, class T, class VectorType>
+  static void interleave(T* base, const std::array<VectorType, Pitch>& vectors)
+  {
+    static_assert(ElementCount == Pitch * SimdSize);
+    using unaligned_type = typename unaligned_vector_extension<T, SimdSize>::type;
+    [&]<int... V>(std::integer_sequence<int, V...>)
+      {
+        ((*reinterpret_cast<unaligned_type*>(base + vector_offset(V)) =
+          lane_shuffle<interleaved_mapping<Pitch, V>, SimdSize, Pitch>::apply(vectors)), ...);
+      } (std::make_integer_sequence<int, vector_count>());
+  }
+};
+
+/**
+ * Loads the elements `base[0]`, `base[Pitch]`, `base[2 * Pitch]`, ... by loading the whole memory block with vector
+ * loads and extracting the elements with shuffle instructions. No memory beyond the last element is accessed.
+ * The deinterleaving is only used, if it needs less loads than an element by element load and if the vector
+ * fits into a native register.
+ * @tparam Pitch Distance of the elements.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Address of the first element.
+ * @return The loaded simd value or nothing (i.e. `void`), if a deinterleaving load is not beneficial.
+ */
+template<int Pitch, class T, int SimdSize>
+inline auto native_pitched_load([[maybe_unused]] const T* base)
+{
+  constexpr int native_size = stdx::native_simd<T>::size();
+  if constexpr (Pitch > 1 && SimdSize > 1 && (SimdSize & (SimdSize - 1)) == 0 && SimdSize <= native_size)
+  {
+    using block = vector_block<SimdSize, (SimdSize - 1) * Pitch + 1>;
+    if constexpr (block::vector_count < SimdSize)
+    {
+      return from_native<stdx::fixed_size_simd<T, SimdSize>>(
+        block::template extract<Pitch, 0>(block::load(base)));
+    }
+  }
+}
+
+/**
+ * Checks, whether `SimdSize` elements of type `T` with a distance of `ElementSize` bytes can be loaded by a
+ * deinterleaving load.
+ */
+template<size_t ElementSize, class T, int SimdSize>
+concept has_native_pitched_load =
+  ElementSize % sizeof(T) == 0 &&
+  !std::is_void_v<decltype(native_pitched_load<int(ElementSize / sizeof(T)), T, SimdSize>(std::declval<const T*>()))>;
+
+/**
+ * Checks, whether `Pitch` vectors of `SimdSize` elements of type `T` can be loaded by a deinterleaving load and stored
+ * by an interleaving store. The vectors must fit into a native register.
+ */
+template<int Pitch, class T, int SimdSize>
+concept has_native_interleaved_access =
+  Pitch > 1 && Pitch <= 16 && SimdSize > 1 && (SimdSize & (SimdSize - 1)) == 0 &&
+  SimdSize <= int(stdx::native_simd<T>::size());
+
+/**
+ * Stores `Pitch` vectors interleaved to the memory block starting at `base`, i.e. lane `i` of vector `k` is stored
+ * to `base[i * Pitch + k]`. The lanes are interleaved by shuffle instructions and stored by contiguous vector stores.
+ * @tparam Pitch Number of vectors to be interleaved.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Address of the first element.
+ * @param vectors The vectors to be interleaved.
+ */
+template<int Pitch, class T, int SimdSize>
+  requires has_native_interleaved_access<Pitch, T, SimdSize>
+inline void native_interleaved_store(T* base, const std::array<vector_extension_t<T, SimdSize>, Pitch>& vectors)
+{
+  vector_block<SimdSize, Pitch * SimdSize>::template interleave<Pitch>(base, vectors);
+}
+
+/**
+ * Loads the memory block of `Pitch * SimdSize` elements starting at `base` by contiguous vector loads and
+ * deinterleaves it into `Pitch` vectors, i.e. lane `i` of vector `k` is set to `base[i * Pitch + k]`. This is the
+ * inverse of `native_interleaved_store`.
+ * @tparam Pitch Number of vectors to be deinterleaved.
+ * @tparam T Element type.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Address of the first element.
+ * @return The deinterleaved vectors.
+ */
+template<int Pitch, class T, int SimdSize>
+  requires has_native_interleaved_access<Pitch, T, SimdSize>
+inline auto native_deinterleaved_load(const T* base)
+{
+  using block = vector_block<SimdSize, Pitch * SimdSize>;
+  auto vectors = block::load(base);
+  return [&]<int... K>(std::integer_sequence<int, K...>)
+    {
+      return std::array<vector_extension_t<T, SimdSize>, Pitch>{ block::template extract<Pitch, K>(vectors)... };
+    } (std::make_integer_sequence<int, Pitch>());
+}
+
+/**
+ * Returns the vector of `SimdSize` consecutive elements starting at lane `Shift` of the concatenation of two vectors,
+ * i.e. the vector between `x` and `y` shifted by `Shift` lanes, if `x` and `y` are consecutive in memory. The shift is
+ * compiled to an align or permute instruction.
+ * @tparam Shift Number of lanes, by which the result is shifted, in the range [0, SimdSize].
+ * @param x The lower vector.
+ * @param y The upper vector.
+ * @return The lanes `x[Shift], ..., x[SimdSize - 1], y[0], ..., y[Shift - 1]`.
+ */
+template<int Shift, class T, int SimdSize>
+inline auto native_align(const stdx::fixed_size_simd<T, SimdSize>& x, const stdx::fixed_size_simd<T, SimdSize>& y)
+{
+  static_assert(Shift >= 0 && Shift <= SimdSize);
+  using simd_type = stdx::fixed_size_simd<T, SimdSize>;
+  if constexpr (Shift == 0)
+  {
+    return x;
+  }
+  else if constexpr (Shift == SimdSize)
+  {
+    return y;
+  }
+  else if constexpr ((SimdSize & (SimdSize - 1)) == 0)
+  {
+    using vector_type = vector_extension_t<T, SimdSize>;
+    return [&]<int... Lane>(std::integer_sequence<int, Lane...>)
+      {
+        return from_native<simd_type>(vector_type(__builtin_shufflevector(to_native<vector_type>(x),
+          to_native<vector_type>(y), (Lane + Shift)...)));
+      } (std::make_integer_sequence<int, SimdSize>());
+  }
+  else
+  {
+    return simd_type([&](auto lane) { return lane + Shift < SimdSize ? x[lane + Shift] : y[lane + Shift - SimdSize]; });
+  }
+}
+
+/**
+ * Converts half precision (IEEE 754 binary16) bit patterns to single precision values by a native instruction (F16C
+ * or AVX-512F).
+ * @tparam SimdSize Vector size of the simd type.
+ * @param bits The bit patterns of the half precision values.
+ * @return The single precision values or nothing (i.e. `void`), if there is no native instruction available.
+ */
+template<int SimdSize>
+inline auto native_float16_to_float([[maybe_unused]] const stdx::fixed_size_simd<std::uint16_t, SimdSize>& bits)
+{
+  using ResultType = stdx::fixed_size_simd<float, SimdSize>;
+#if defined(__AVX512F__)
+  if constexpr (SimdSize == 16)
+  {
+    return from_native<ResultType>(_mm512_cvtph_ps(to_native<__m256i>(bits)));
+  }
+  else
+#endif
+#if defined(__F16C__)
+  if constexpr (SimdSize == 8)
+  {
+    return from_native<ResultType>(_mm256_cvtph_ps(to_native<__m128i>(bits)));
+  }
+  else if constexpr (SimdSize == 4)
+  {
+    return from_native<ResultType>(_mm_cvtph_ps(to_native<__m128i>(bits)));
+  }
+  else
+#endif
+  {
+    return;
+  }
+}
+
+/**
+ * Converts single precision values to half precision (IEEE 754 binary16) bit patterns by a native instruction (F16C
+ * or AVX-512F). The values are rounded to nearest even.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param values The single precision values.
+ * @return The bit patterns of the half precision values or nothing (i.e. `void`), if there is no native instruction
+ *   available.
+ */
+template<int SimdSize>
+inline auto native_float_to_float16([[maybe_unused]] const stdx::fixed_size_simd<float, SimdSize>& values)
+{
+  using ResultType = stdx::fixed_size_simd<std::uint16_t, SimdSize>;
+#if defined(__AVX512F__)
+  if constexpr (SimdSize == 16)
+  {
+    return from_native<ResultType>(
+      _mm512_cvtps_ph(to_native<__m512>(values), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  else
+#endif
+#if defined(__F16C__)
+  if constexpr (SimdSize == 8)
+  {
+    return from_native<ResultType>(
+      _mm256_cvtps_ph(to_native<__m256>(values), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  else if constexpr (SimdSize == 4)
+  {
+    return from_native<ResultType>(
+      _mm_cvtps_ph(to_native<__m128>(values), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  else
+#endif
+  {
+    return;
+  }
+}
+
+/**
+ * Checks, whether `SimdSize` half precision values can be converted from and to single precision by native
+ * instructions.
+ */
+template<int SimdSize>
+concept has_native_float16_conversion =
+  !std::is_void_v<decltype(native_float16_to_float(std::declval<stdx::fixed_size_simd<std::uint16_t, SimdSize>>()))>;
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_INTRINSICS
@@ -8,9 +8,15 @@
 #ifndef SIMD_LOAD_STORE
 #define SIMD_LOAD_STORE
 
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
 #include "simd_access/base.hpp"
+#include "simd_access/encoding.hpp"
 #include "simd_access/location.hpp"
 #include "simd_access/index.hpp"
+#include "simd_access/intrinsics.hpp"
 
 namespace simd_access
 {
@@ -65,6 +71,7 @@ inline void store(const indexed_location<T, SimdSize, ArrayType>& location,
 /**
  * Loads a simd value from a memory location defined by a base address and an linear index. The simd elements to be
  * loaded are located at the positions base, base+ElementSize, base+2*ElementSize, ...
+ * If possible, elements with a constant pitch are loaded by vector loads and extracted by shuffle instructions.
  * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
  * @tparam T Type of a simd element.
  * @tparam SimdSize Vector size of the simd type.
@@ -79,6 +86,10 @@ inline auto load(const linear_location<T, SimdSize>& location)
   {
     return ResultType(location.base_, stdx::element_aligned);
   }
+  else if constexpr (has_native_pitched_load<ElementSize, std::remove_const_t<T>, SimdSize>)
+  {
+    return native_pitched_load<int(ElementSize / sizeof(T)), std::remove_const_t<T>, SimdSize>(location.base_);
+  }
   else
   {
     // gather with constant pitch
@@ -92,6 +103,7 @@ inline auto load(const linear_location<T, SimdSize>& location)
 /**
  * Loads a simd value from a memory location defined by a base address and an indirect index. The simd elements to be
  * loaded are stored at the positions base+indices[0]*ElementSize, base+indices[1]*ElementSize, ...
+ * If available, a native gather instruction is used.
  * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
  * @tparam T Deduced type of a simd element.
  * @tparam SimdSize Deduced vector size of the simd type.
@@ -102,12 +114,557 @@ inline auto load(const linear_location<T, SimdSize>& location)
 template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType>
 inline auto load(const indexed_location<T, SimdSize, ArrayType>& location)
 {
-  // gather with indirect indices
-  return stdx::fixed_size_simd<std::remove_const_t<T>, SimdSize>([&](int i)
+  using ValueType = std::remove_const_t<T>;
+  using IndexType = std::remove_cvref_t<decltype(location.indices_[0])>;
+  if constexpr (has_native_gather<ElementSize, ValueType, IndexType, SimdSize>)
+  {
+    return native_gather<ElementSize, ValueType>(location.base_,
+      stdx::fixed_size_simd<IndexType, SimdSize>([&](int i) { return location.indices_[i]; }));
+  }
+  else
+  {
+    // gather with indirect indices
+    return stdx::fixed_size_simd<ValueType, SimdSize>([&](int i)
+      {
+        return *reinterpret_cast<const T*>
+          (reinterpret_cast<const char*>(location.base_) + ElementSize * location.indices_[i]);
+      });
+  }
+}
+
+/**
+ * Returns the indices of the active lanes of a masked index array as simd value. Indices of inactive lanes are zero.
+ * Entries of inactive lanes are only read, if the index array is no iterator, i.e. if all entries exist.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param indices The index array.
+ * @param mask The simd mask.
+ * @return The indices as simd value.
+ */
+template<int SimdSize, class ArrayType, class MaskType>
+inline auto masked_indices(const ArrayType& indices, const MaskType& mask)
+{
+  using IndexType = std::remove_cvref_t<decltype(indices[0])>;
+  using ResultType = stdx::fixed_size_simd<IndexType, SimdSize>;
+  if constexpr (std::contiguous_iterator<ArrayType>)
+  {
+    ResultType result = 0;
+    stdx::where(typename ResultType::mask_type(mask), result).copy_from(std::to_address(indices),
+      stdx::element_aligned);
+    return result;
+  }
+  else if constexpr (std::random_access_iterator<ArrayType>)
+  {
+    return ResultType([&](int i) { return mask[i] ? indices[i] : IndexType(0); });
+  }
+  else
+  {
+    ResultType result([&](int i) { return indices[i]; });
+    stdx::where(!typename ResultType::mask_type(mask), result) = 0;
+    return result;
+  }
+}
+
+/**
+ * Stores the active lanes of a simd value to a memory location defined by a base address and an linear index. The
+ * simd elements are stored at the positions base, base+ElementSize, base+2*ElementSize, ... No memory of inactive
+ * lanes is touched. Native masked store or scatter instructions are used, if available.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address of the memory location, at which the first simd element is stored, and the mask.
+ * @param source Simd value to be stored.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class MaskType>
+inline void store(const masked_location<linear_location<T, SimdSize>, MaskType>& location,
+  const stdx::fixed_size_simd<T, SimdSize>& source)
+{
+  const typename stdx::fixed_size_simd<T, SimdSize>::mask_type mask(location.mask_);
+  if constexpr (sizeof(T) == ElementSize)
+  {
+    stdx::where(mask, source).copy_to(location.location_.base_, stdx::element_aligned);
+  }
+  else if constexpr (has_native_scatter<ElementSize, T, int, SimdSize>)
+  {
+    native_scatter<ElementSize>(location.location_.base_,
+      stdx::fixed_size_simd<int, SimdSize>([](int i) { return i; }), source, mask);
+  }
+  else
+  {
+    // masked scatter with constant pitch
+    for (int i = 0; i < SimdSize; ++i)
     {
-      return *reinterpret_cast<const T*>
-        (reinterpret_cast<const char*>(location.base_) + ElementSize * location.indices_[i]);
-    });
+      if (mask[i])
+      {
+        *reinterpret_cast<T*>(reinterpret_cast<char*>(location.location_.base_) + ElementSize * i) = source[i];
+      }
+    }
+  }
+}
+
+/**
+ * Stores the active lanes of a simd value to a memory location defined by a base address and an indirect index. The
+ * simd elements are stored at the positions base+indices[0]*ElementSize, base+indices[1]*ElementSize, ...
+ * If available, a native scatter instruction is used.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam ArrayType Deduced type of the array storing the indices.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address, indices and mask of the memory location.
+ * @param source Simd value to be stored.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType, class MaskType>
+inline void store(const masked_location<indexed_location<T, SimdSize, ArrayType>, MaskType>& location,
+  const stdx::fixed_size_simd<T, SimdSize>& source)
+{
+  const auto& indexed = location.location_;
+  using IndexType = std::remove_cvref_t<decltype(indexed.indices_[0])>;
+  if constexpr (has_native_scatter<ElementSize, T, IndexType, SimdSize>)
+  {
+    const typename stdx::fixed_size_simd<T, SimdSize>::mask_type mask(location.mask_);
+    native_scatter<ElementSize>(indexed.base_, masked_indices<SimdSize>(indexed.indices_, mask), source, mask);
+  }
+  else
+  {
+    // masked scatter with indirect indices
+    for (int i = 0; i < SimdSize; ++i)
+    {
+      if (location.mask_[i])
+      {
+        *reinterpret_cast<T*>(reinterpret_cast<char*>(indexed.base_) + ElementSize * indexed.indices_[i]) =
+          source[i];
+      }
+    }
+  }
+}
+
+/**
+ * Loads the active lanes of a simd value from a memory location defined by a base address and an linear index. The
+ * simd elements to be loaded are located at the positions base, base+ElementSize, base+2*ElementSize, ...
+ * No memory of inactive lanes is touched, inactive lanes of the result are zero. Native masked load or gather
+ * instructions are used, if available.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Type of a simd element.
+ * @tparam SimdSize Vector size of the simd type.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address of the memory location, at which the first scalar element is stored, and the mask.
+ * @return A simd value.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class MaskType>
+inline auto load(const masked_location<linear_location<T, SimdSize>, MaskType>& location)
+{
+  using ResultType = stdx::fixed_size_simd<std::remove_const_t<T>, SimdSize>;
+  const typename ResultType::mask_type mask(location.mask_);
+  if constexpr (sizeof(T) == ElementSize)
+  {
+    ResultType result = 0;
+    stdx::where(mask, result).copy_from(location.location_.base_, stdx::element_aligned);
+    return result;
+  }
+  else if constexpr (has_native_gather<ElementSize, std::remove_const_t<T>, int, SimdSize>)
+  {
+    return native_gather<ElementSize>(location.location_.base_,
+      stdx::fixed_size_simd<int, SimdSize>([](int i) { return i; }), mask);
+  }
+  else
+  {
+    // masked gather with constant pitch
+    return ResultType([&](int i)
+      {
+        return mask[i] ?
+          *reinterpret_cast<const T*>(reinterpret_cast<const char*>(location.location_.base_) + ElementSize * i) :
+          T();
+      });
+  }
+}
+
+/**
+ * Loads the active lanes of a simd value from a memory location defined by a base address and an indirect index. The
+ * simd elements to be loaded are stored at the positions base+indices[0]*ElementSize, base+indices[1]*ElementSize, ...
+ * Inactive lanes of the result are zero. If available, a native gather instruction is used.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam ArrayType Deduced type of the array storing the indices.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address, indices and mask of the memory location.
+ * @return A simd value.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType, class MaskType>
+inline auto load(const masked_location<indexed_location<T, SimdSize, ArrayType>, MaskType>& location)
+{
+  using ResultType = stdx::fixed_size_simd<std::remove_const_t<T>, SimdSize>;
+  const auto& indexed = location.location_;
+  using IndexType = std::remove_cvref_t<decltype(indexed.indices_[0])>;
+  if constexpr (has_native_gather<ElementSize, std::remove_const_t<T>, IndexType, SimdSize>)
+  {
+    const typename ResultType::mask_type mask(location.mask_);
+    return native_gather<ElementSize, std::remove_const_t<T>>(indexed.base_,
+      masked_indices<SimdSize>(indexed.indices_, mask), mask);
+  }
+  else
+  {
+    // masked gather with indirect indices
+    return ResultType([&](int i)
+      {
+        auto address = reinterpret_cast<const char*>(indexed.base_);
+        return location.mask_[i] ? *reinterpret_cast<const T*>(address + ElementSize * indexed.indices_[i]) : T();
+      });
+  }
+}
+
+/**
+ * Loads a value from elements with a constant distance known at runtime. The offsets of the lanes are computed in a
+ * register and the elements are gathered like indirect indexed elements (see `indexed_location`).
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param location Address and stride of the memory location.
+ * @return The loaded value.
+ */
+template<size_t ElementSize, class T, int SimdSize, class StrideType>
+inline auto load(const strided_location<T, SimdSize, StrideType>& location)
+{
+  const auto offsets = location.offsets();
+  return load<ElementSize>(indexed_location<T, SimdSize, decltype(offsets)>{location.base_, offsets});
+}
+
+/**
+ * Stores a value to elements with a constant distance known at runtime like to indirect indexed elements.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param location Address and stride of the memory location.
+ * @param source Value to be stored.
+ */
+template<size_t ElementSize, class T, int SimdSize, class StrideType>
+inline void store(const strided_location<T, SimdSize, StrideType>& location, const auto& source)
+{
+  const auto offsets = location.offsets();
+  store<ElementSize>(indexed_location<T, SimdSize, decltype(offsets)>{location.base_, offsets}, source);
+}
+
+/**
+ * Loads the active lanes of a value from elements with a constant distance known at runtime.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param location Address, stride and mask of the memory location.
+ * @return The loaded value, inactive lanes are zero.
+ */
+template<size_t ElementSize, class T, int SimdSize, class StrideType, class MaskType>
+inline auto load(const masked_location<strided_location<T, SimdSize, StrideType>, MaskType>& location)
+{
+  const auto offsets = location.location_.offsets();
+  using indexed_type = indexed_location<T, SimdSize, decltype(offsets)>;
+  return load<ElementSize>(
+    masked_location<indexed_type, MaskType>{{location.location_.base_, offsets}, location.mask_});
+}
+
+/**
+ * Stores the active lanes of a value to elements with a constant distance known at runtime.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param location Address, stride and mask of the memory location.
+ * @param source Value to be stored.
+ */
+template<size_t ElementSize, class T, int SimdSize, class StrideType, class MaskType>
+inline void store(const masked_location<strided_location<T, SimdSize, StrideType>, MaskType>& location,
+  const auto& source)
+{
+  const auto offsets = location.location_.offsets();
+  using indexed_type = indexed_location<T, SimdSize, decltype(offsets)>;
+  store<ElementSize>(masked_location<indexed_type, MaskType>{{location.location_.base_, offsets}, location.mask_},
+    source);
+}
+
+/**
+ * Stores a simd value to consecutive elements by a non-temporal store, which doesn't allocate cache lines for the
+ * written data. The ordinary store is used, if the elements aren't aligned to the vector size or if there is no
+ * native non-temporal store for the simd type.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @param location Address of the memory location, at which the first simd element is stored.
+ * @param source Simd value to be stored.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize>
+inline void store(const streaming_location<linear_location<T, SimdSize>>& location,
+  const stdx::fixed_size_simd<T, SimdSize>& source)
+{
+  if constexpr (sizeof(T) == ElementSize && has_native_stream_store<T, SimdSize>)
+  {
+    if (reinterpret_cast<std::uintptr_t>(location.location_.base_) % (sizeof(T) * SimdSize) == 0)
+    {
+      native_stream_store(location.location_.base_, source);
+      return;
+    }
+  }
+  store<ElementSize>(location.location_, source);
+}
+
+/**
+ * Stores a value to a streaming location, which can't be streamed (e.g. structures or scattered elements), by the
+ * ordinary store of the underlying location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the underlying location.
+ * @param location The streaming location.
+ * @param source Value to be stored.
+ */
+template<size_t ElementSize, class Location>
+inline void store(const streaming_location<Location>& location, const auto& source)
+{
+  store<ElementSize>(location.location_, source);
+}
+
+/**
+ * Loads a value from a streaming location. Loads aren't affected by streaming, thus the value is loaded from the
+ * underlying location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the underlying location.
+ * @param location The streaming location.
+ * @return The loaded value.
+ */
+template<size_t ElementSize, class Location>
+inline auto load(const streaming_location<Location>& location)
+{
+  return load<ElementSize>(location.location_);
+}
+
+/**
+ * Stores a simd value to consecutive elements, whose first element is aligned to the vector size. Elements, which
+ * aren't of the size of the simd element type, are stored by the ordinary store.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @param location Aligned address of the memory location, at which the first simd element is stored.
+ * @param source Simd value to be stored.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize>
+inline void store(const aligned_location<linear_location<T, SimdSize>>& location,
+  const stdx::fixed_size_simd<T, SimdSize>& source)
+{
+  constexpr size_t alignment = sizeof(T) * SimdSize;
+  if constexpr (sizeof(T) == ElementSize && (alignment & (alignment - 1)) == 0)
+  {
+    source.copy_to(location.location_.base_, stdx::overaligned<alignment>);
+  }
+  else
+  {
+    store<ElementSize>(location.location_, source);
+  }
+}
+
+/**
+ * Stores a value to an aligned location, whose alignment can't be exploited (e.g. structures or scattered elements),
+ * by the ordinary store of the underlying location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the underlying location.
+ * @param location The aligned location.
+ * @param source Value to be stored.
+ */
+template<size_t ElementSize, class Location>
+inline void store(const aligned_location<Location>& location, const auto& source)
+{
+  store<ElementSize>(location.location_, source);
+}
+
+/**
+ * Loads a simd value from consecutive elements, whose first element is aligned to the vector size. Elements, which
+ * aren't of the size of the simd element type, are loaded by the ordinary load.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @param location Aligned address of the memory location, at which the first scalar element is stored.
+ * @return A simd value.
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize>
+inline auto load(const aligned_location<linear_location<T, SimdSize>>& location)
+{
+  constexpr size_t alignment = sizeof(T) * SimdSize;
+  if constexpr (sizeof(T) == ElementSize && (alignment & (alignment - 1)) == 0)
+  {
+    return stdx::fixed_size_simd<std::remove_const_t<T>, SimdSize>(location.location_.base_,
+      stdx::overaligned<alignment>);
+  }
+  else
+  {
+    return load<ElementSize>(location.location_);
+  }
+}
+
+/**
+ * Loads a value from an aligned location, whose alignment can't be exploited, by the ordinary load of the underlying
+ * location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the underlying location.
+ * @param location The aligned location.
+ * @return The loaded value.
+ */
+template<size_t ElementSize, class Location>
+inline auto load(const aligned_location<Location>& location)
+{
+  return load<ElementSize>(location.location_);
+}
+
+/**
+ * Loads a simd value of an arithmetic compute type from elements stored in a compact type (e.g. `float` elements as
+ * `double` values). The stored elements are loaded by the underlying location and widened in registers.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the location of the stored elements.
+ * @tparam ComputeType Deduced type of the loaded values.
+ * @tparam Encoding Deduced conversion between the stored type and `ComputeType`.
+ * @param location The converting location.
+ * @return A simd value of `ComputeType`.
+ */
+template<size_t ElementSize, class Location, simd_arithmetic ComputeType, class Encoding>
+inline auto load(const converting_location<Location, ComputeType, Encoding>& location)
+{
+  stdx::fixed_size_simd<ComputeType, location_simd_size<Location>> result;
+  location.encoding_.decode(result, load<ElementSize>(location.location_));
+  return result;
+}
+
+/**
+ * Stores a value of an arithmetic compute type to elements stored in a compact type. The value is narrowed in
+ * registers, rounded to nearest even, and stored by the underlying location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the location of the stored elements.
+ * @tparam ComputeType Deduced type of the stored values.
+ * @tparam Encoding Deduced conversion between the stored type and `ComputeType`.
+ * @param location The converting location.
+ * @param source Value to be stored, which is convertible to a simd value of `ComputeType`.
+ */
+template<size_t ElementSize, class Location, simd_arithmetic ComputeType, class Encoding>
+inline void store(const converting_location<Location, ComputeType, Encoding>& location, const auto& source)
+{
+  constexpr int simd_size = location_simd_size<Location>;
+  stdx::fixed_size_simd<std::remove_const_t<typename Location::value_type>, simd_size> stored;
+  location.encoding_.encode(stored, stdx::fixed_size_simd<ComputeType, simd_size>(source));
+  store<ElementSize>(location.location_, stored);
+}
+
+/**
+ * Determines the active lanes of a simd index, whose index equals the index of a preceding active lane. If available,
+ * the AVX-512CD conflict detection instruction is used, otherwise the lanes are compared in registers.
+ * @tparam IndexType Deduced type of the indices.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @param indices The indices.
+ * @param mask Mask of the active lanes.
+ * @return A mask of the lanes, which duplicate a preceding lane.
+ */
+template<class IndexType, int SimdSize>
+inline auto duplicate_lanes(const stdx::fixed_size_simd<IndexType, SimdSize>& indices,
+  const stdx::fixed_size_simd_mask<IndexType, SimdSize>& mask)
+{
+  using IndexSimdType = stdx::fixed_size_simd<IndexType, SimdSize>;
+  if constexpr (has_native_conflict<IndexType, SimdSize>)
+  {
+    IndexType active_lanes = 0;
+    for (int i = 0; i < SimdSize; ++i)
+    {
+      active_lanes |= IndexType(IndexType(mask[i]) << i);
+    }
+    return mask && (native_conflict(indices) & active_lanes) != 0;
+  }
+  else
+  {
+    const IndexSimdType lanes([](int i) { return IndexType(i); });
+    typename IndexSimdType::mask_type result(false);
+    for (int k = 0; k < SimdSize - 1; ++k)
+    {
+      if (mask[k])
+      {
+        result |= indices == indices[k] && lanes > IndexType(k);
+      }
+    }
+    return result && mask;
+  }
+}
+
+/**
+ * Applies a compound assignment (e.g. `+=`) to a memory location. The result of `op(load(location), source)` is
+ * stored to the location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @param location Memory location.
+ * @param source Right hand side of the compound assignment.
+ * @param op Binary operation of the compound assignment.
+ */
+template<size_t ElementSize, class Location>
+inline void store_compound(const Location& location, const auto& source, auto&& op, auto&&)
+{
+  store<ElementSize>(location, op(load<ElementSize>(location), source));
+}
+
+/**
+ * Applies a compound assignment (e.g. `+=`) to the active lanes of indirect indexed elements. Lanes with equal
+ * indices are combined before the elements are loaded and stored, thus no update is lost, if the index array contains
+ * duplicates. For lanes i, j, k with equal indices the element `x` is updated to `op(x, combine(combine(source[i],
+ * source[j]), source[k]))`, which equals `op(op(op(x, source[i]), source[j]), source[k])` except for rounding.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of a simd element.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam ArrayType Deduced type of the array storing the indices.
+ * @param location Address and indices of the memory location.
+ * @param mask Mask of the active lanes.
+ * @param source Right hand side of the compound assignment.
+ * @param op Binary operation of the compound assignment.
+ * @param combine Binary operation combining two right hand sides of lanes with equal indices (e.g. `+` for `-=`).
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType>
+inline void store_compound_indexed(const indexed_location<T, SimdSize, ArrayType>& location,
+  const typename stdx::fixed_size_simd<T, SimdSize>::mask_type& mask, const stdx::fixed_size_simd<T, SimdSize>& source,
+  auto&& op, auto&& combine)
+{
+  using ValueType = stdx::fixed_size_simd<T, SimdSize>;
+  using IndexType = std::remove_cvref_t<decltype(location.indices_[0])>;
+  using IndexSimdType = stdx::fixed_size_simd<IndexType, SimdSize>;
+  const typename IndexSimdType::mask_type index_mask(mask);
+  const auto indices = masked_indices<SimdSize>(location.indices_, index_mask);
+  const auto duplicates = duplicate_lanes(indices, index_mask);
+  auto update = [&](const auto& target, const ValueType& value)
+    {
+      store<ElementSize>(target, ValueType(op(load<ElementSize>(target), value)));
+    };
+  if (stdx::none_of(duplicates))
+  {
+    update(make_masked_location(location, mask), source);
+    return;
+  }
+
+  // accumulate the duplicates in the first lane of their index
+  const IndexSimdType lanes([](int i) { return IndexType(i); });
+  ValueType combined = source;
+  for (int k = 1; k < SimdSize; ++k)
+  {
+    if (duplicates[k])
+    {
+      auto first = indices == indices[k] && lanes < IndexType(k) && !duplicates;
+      stdx::where(typename ValueType::mask_type(first), combined) = combine(combined, ValueType(source[k]));
+    }
+  }
+  update(make_masked_location(location, mask && !typename ValueType::mask_type(duplicates)), combined);
+}
+
+/**
+ * Applies a compound assignment to indirect indexed elements without losing updates of duplicate indices (see
+ * `store_compound_indexed`).
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType, class SourceType>
+  requires(std::is_convertible_v<SourceType, stdx::fixed_size_simd<T, SimdSize>>)
+inline void store_compound(const indexed_location<T, SimdSize, ArrayType>& location, const SourceType& source,
+  auto&& op, auto&& combine)
+{
+  store_compound_indexed<ElementSize>(location, typename stdx::fixed_size_simd<T, SimdSize>::mask_type(true),
+    stdx::fixed_size_simd<T, SimdSize>(source), op, combine);
+}
+
+/**
+ * Applies a compound assignment to the active lanes of indirect indexed elements without losing updates of duplicate
+ * indices (see `store_compound_indexed`).
+ */
+template<size_t ElementSize, simd_arithmetic T, int SimdSize, class ArrayType, class MaskType, class SourceType>
+  requires(std::is_convertible_v<SourceType, stdx::fixed_size_simd<T, SimdSize>>)
+inline void store_compound(const masked_location<indexed_location<T, SimdSize, ArrayType>, MaskType>& location,
+  const SourceType& source, auto&& op, auto&& combine)
+{
+  store_compound_indexed<ElementSize>(location.location_,
+    typename stdx::fixed_size_simd<T, SimdSize>::mask_type(location.mask_), stdx::fixed_size_simd<T, SimdSize>(source),
+    op, combine);
 }
 
 /**
@@ -120,7 +677,10 @@ inline auto load(const indexed_location<T, SimdSize, ArrayType>& location)
 template<simd_arithmetic BaseType>
 inline auto load_rvalue(auto&& base, const auto& idx)
 {
-  return stdx::fixed_size_simd<BaseType, idx.size()>([&](auto i) { return base[get_index(idx, i)]; });
+  return stdx::fixed_size_simd<BaseType, idx.size()>([&](auto i)
+    {
+      return is_active_lane(idx, i) ? BaseType(base[get_index(idx, i)]) : BaseType();
+    });
 }
 
 /**
@@ -135,7 +695,10 @@ inline auto load_rvalue(auto&& base, const auto& idx)
 template<simd_arithmetic BaseType>
 inline auto load_rvalue(auto&& base, const auto& idx, auto&& subobject)
 {
-  return stdx::fixed_size_simd<BaseType, idx.size()>([&](auto i) { return subobject(base[get_index(idx, i)]); });
+  return stdx::fixed_size_simd<BaseType, idx.size()>([&](auto i)
+    {
+      return is_active_lane(idx, i) ? BaseType(subobject(base[get_index(idx, i)])) : BaseType();
+    });
 }
 
 } //namespace simd_access
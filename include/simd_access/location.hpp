@@ -10,6 +10,8 @@
 
 #include <type_traits>
 
+#include "simd_access/base.hpp"
+
 namespace simd_access
 {
 
@@ -78,9 +80,214 @@ struct random_location
   }
 };
 
-} //namespace simd_access
+/**
+ * Location of elements with a constant distance, which is known at runtime. The lane `i` is located at
+ * `base + ElementSize * i * stride_` bytes.
+ * @tparam T Type of the accessed (sub-)object.
+ * @tparam SimdSize Vector size.
+ * @tparam StrideType Integral type of the stride.
+ */
+template<class T, int SimdSize, class StrideType>
+struct strided_location
+{
+  using value_type = T;
+  T* base_;
+  /// Distance of the elements in units of the indexed array elements.
+  StrideType stride_;
 
-#endif //SIMD_ACCESS_LOCATION
+  /// Return the offsets of the lanes in units of the indexed array elements.
+  auto offsets() const
+  {
+    return stdx::fixed_size_simd<StrideType, SimdSize>([](int i) { return StrideType(i); }) * stride_;
+  }
+
+  template<auto Member>
+  auto member_access() const
+  {
+    return strided_location<std::remove_reference_t<decltype(std::declval<T>().*Member)>, SimdSize, StrideType>
+      {&(base_->*Member), stride_};
+  }
+
+  auto array_access(auto i) const
+  {
+    return strided_location<std::remove_reference_t<decltype((*base_)[i])>, SimdSize, StrideType>
+      {&((*base_)[i]), stride_};
+  }
+};
+
+/**
+ * Location restricted to the active lanes of a simd mask. Inactive lanes are neither read nor written, thus they may
+ * refer to memory beyond the end of an array. For indirect locations, inactive entries of the index array aren't
+ * read either.
+ * @tparam Location Type of the unrestricted location.
+ * @tparam MaskType Type of the simd mask.
+ */
+template<class Location, class MaskType>
+struct masked_location
+{
+  using value_type = typename Location::value_type;
+  Location location_;
+  MaskType mask_;
+
+  template<auto Member>
+  auto member_access() const
+  {
+    using member_location = decltype(location_.template member_access<Member>());
+    return masked_location<member_location, MaskType>{location_.template member_access<Member>(), mask_};
+  }
+
+  auto array_access(auto i) const
+  {
+    return masked_location<decltype(location_.array_access(i)), MaskType>{location_.array_access(i), mask_};
+  }
+};
+
+/**
+ * Restricts a location to the active lanes of a simd mask.
+ * @param location The unrestricted location.
+ * @param mask Simd mask.
+ * @return The masked location.
+ */
+template<class Location, class MaskType>
+inline auto make_masked_location(const Location& location, const MaskType& mask)
+{
+  return masked_location<Location, MaskType>{location, mask};
+}
+
+/**
+ * Restricts a masked location further to the active lanes of another simd mask.
+ * @param location The masked location.
+ * @param mask Simd mask, which is combined with the mask of `location`.
+ * @return The masked location, whose active lanes are active in both masks.
+ */
+template<class Location, class MaskType, class OtherMaskType>
+inline auto make_masked_location(const masked_location<Location, MaskType>& location, const OtherMaskType& mask)
+{
+  return masked_location<Location, MaskType>{location.location_, location.mask_ && MaskType(mask)};
+}
+
+/**
+ * Location, which is written by non-temporal (streaming) stores bypassing the cache. Only consecutive elements of
+ * arithmetic type at an aligned address are streamed, all other stores and all loads fall back to `Location`.
+ * @tparam Location Type of the location, which is written.
+ */
+template<class Location>
+struct streaming_location
+{
+  using value_type = typename Location::value_type;
+  Location location_;
+
+  template<auto Member>
+  auto member_access() const
+  {
+    using member_location = decltype(location_.template member_access<Member>());
+    return streaming_location<member_location>{location_.template member_access<Member>()};
+  }
+
+  auto array_access(auto i) const
+  {
+    return streaming_location<decltype(location_.array_access(i))>{location_.array_access(i)};
+  }
+};
+
+/**
+ * Restricts a streaming location to the active lanes of a simd mask. Masked stores aren't streamed.
+ * @param location The streaming location.
+ * @param mask Simd mask.
+ * @return The masked location.
+ */
+template<class Location, class MaskType>
+inline auto make_masked_location(const streaming_location<Location>& location, const MaskType& mask)
+{
+  return make_masked_location(location.location_, mask);
+}
+
+/**
+ * Location, whose first element is aligned to the vector size. Consecutive elements of arithmetic type are loaded and
+ * stored by aligned vector accesses, all other accesses fall back to `Location`.
+ * @tparam Location Type of the aligned location.
+ */
+template<class Location>
+struct aligned_location
+{
+  using value_type = typename Location::value_type;
+  Location location_;
+
+  template<auto Member>
+  auto member_access() const
+  {
+    using member_location = decltype(location_.template member_access<Member>());
+    return aligned_location<member_location>{location_.template member_access<Member>()};
+  }
+
+  auto array_access(auto i) const
+  {
+    return aligned_location<decltype(location_.array_access(i))>{location_.array_access(i)};
+  }
+};
+
+/**
+ * Restricts an aligned location to the active lanes of a simd mask. Masked accesses don't make use of the alignment.
+ * @param location The aligned location.
+ * @param mask Simd mask.
+ * @return The masked location.
+ */
+template<class Location, class MaskType>
+inline auto make_masked_location(const aligned_location<Location>& location, const MaskType& mask)
+{
+  return make_masked_location(location.location_, mask);
+}
+
+/**
+ * Location, whose elements are stored in a compact type and computed in `ComputeType`. Loads widen the stored
+ * elements to `ComputeType`, stores narrow the values to the stored type, both as described by `Encoding`. Members
+ * and sub-arrays must be selected before the conversion is applied, i.e. `value_type` is the type of the whole
+ * converted object.
+ * @tparam Location Type of the location of the stored elements.
+ * @tparam ComputeType Arithmetic type or structure type, in which the elements are computed.
+ * @tparam Encoding Conversion between the stored type and `ComputeType` (e.g. `cast_encoding`).
+ */
+template<class Location, class ComputeType, class Encoding>
+struct converting_location
+{
+  using value_type = ComputeType;
+  Location location_;
+  /// The conversion, which may carry parameters (e.g. the scale of a `linear_quantization`).
+  [[no_unique_address]] Encoding encoding_;
+};
+
+/**
+ * Restricts a converting location to the active lanes of a simd mask. The stored elements are accessed by the masked
+ * underlying location.
+ * @param location The converting location.
+ * @param mask Simd mask.
+ * @return The masked converting location.
+ */
+template<class Location, class ComputeType, class Encoding, class MaskType>
+inline auto make_masked_location(const converting_location<Location, ComputeType, Encoding>& location,
+  const MaskType& mask)
+{
+  using masked_type = decltype(make_masked_location(location.location_, mask));
+  return converting_location<masked_type, ComputeType, Encoding>{make_masked_location(location.location_, mask),
+    location.encoding_};
+}
+
+/// Vector size of a location. Locations wrapping another location (e.g. `masked_location`) have its vector size.
+template<class Location>
+inline constexpr int location_simd_size = location_simd_size<decltype(Location::location_)>;
+
+template<class T, int SimdSize>
+inline constexpr int location_simd_size<linear_location<T, SimdSize>> = SimdSize;
 
+template<class T, int SimdSize, class ArrayType>
+inline constexpr int location_simd_size<indexed_location<T, SimdSize, ArrayType>> = SimdSize;
+
+template<class T, int SimdSize>
+inline constexpr int location_simd_size<random_location<T, SimdSize>> = SimdSize;
 
+template<class T, int SimdSize, class StrideType>
+inline constexpr int location_simd_size<strided_location<T, SimdSize, StrideType>> = SimdSize;
 
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_LOCATION
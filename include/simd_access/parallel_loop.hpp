@@ -0,0 +1,537 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Functions looping over a given function in simd-style using multiple threads.
+ *
+ * The iteration range is split into chunks, whose sizes are multiples of the vector size. The chunks are executed
+ * by a built-in thread pool, which balances the load by work stealing. Inside a chunk the iteration is the same as in
+ * `loop`, thus the function is called with simd indices and residual iterations occur only at the end of the whole
+ * range.
+ */
+
+#ifndef SIMD_ACCESS_PARALLEL_LOOP
+#define SIMD_ACCESS_PARALLEL_LOOP
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "simd_access/simd_loop.hpp"
+
+namespace simd_access
+{
+
+/// Pool of worker threads, which execute the tasks of a parallel loop.
+/**
+ * The thread calling `run` participates in the execution, thus a pool of size n uses n-1 worker threads. Calls of
+ * `run` from different threads are serialized. Nested calls of `run` from inside a task are executed sequentially
+ * by the calling thread.
+ *
+ * The tasks are scheduled by work stealing: Each thread owns a queue of consecutive tasks, which is initially an
+ * equal share of all tasks. A thread executes the tasks of its own queue from the front. If its queue is empty, it
+ * steals the back half of the queue of another thread. Thus, load imbalances caused by tasks of different costs are
+ * absorbed, while every thread still executes mostly consecutive tasks.
+ */
+class thread_pool
+{
+public:
+  /// Constructor.
+  /**
+   * @param thread_count Number of threads executing the tasks including the thread calling `run`.
+   */
+  explicit thread_pool(unsigned thread_count = std::max(1u, std::thread::hardware_concurrency())) :
+    queues_(std::make_unique<task_queue[]>(std::max(1u, thread_count)))
+  {
+    for (unsigned i = 1; i < thread_count; ++i)
+    {
+      workers_.emplace_back([this, i]() { work(i); });
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  /// Destructor, waits for all worker threads to finish.
+  ~thread_pool()
+  {
+    {
+      std::lock_guard lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_)
+    {
+      worker.join();
+    }
+  }
+
+  /// Return the number of threads executing tasks.
+  /**
+   * @return The number of threads including the thread calling `run`.
+   */
+  unsigned size() const { return unsigned(workers_.size()) + 1; }
+
+  /// Return the maximum number of tasks of one call of `run`.
+  /**
+   * @return The maximum number of tasks.
+   */
+  static constexpr size_t max_task_count() { return std::numeric_limits<uint32_t>::max(); }
+
+  /// Executes tasks in parallel and waits for their completion.
+  /**
+   * If a task throws an exception, the remaining tasks are skipped and the first exception is rethrown.
+   * @param task_count Number of tasks, must not exceed `max_task_count()`.
+   * @param task Function called with the task number in the range [0, task_count).
+   */
+  template<class Fn>
+  void run(size_t task_count, Fn&& task)
+  {
+    if (task_count == 0)
+    {
+      return;
+    }
+    if (is_executing_task() || workers_.empty() || task_count == 1)
+    {
+      for (size_t i = 0; i < task_count; ++i)
+      {
+        task(i);
+      }
+      return;
+    }
+
+    std::lock_guard run_lock(run_mutex_);
+    {
+      std::lock_guard lock(mutex_);
+      job_ = &task;
+      invoke_ = [](void* job, size_t i) { (*static_cast<std::remove_reference_t<Fn>*>(job))(i); };
+      for (size_t i = 0, n = size(); i < n; ++i)
+      {
+        queues_[i].assign(task_count * i / n, task_count * (i + 1) / n);
+      }
+      cancelled_ = false;
+      exception_ = nullptr;
+      busy_workers_ = workers_.size();
+      ++generation_;
+    }
+    wake_.notify_all();
+    is_executing_task() = true;
+    execute(0);
+    is_executing_task() = false;
+
+    std::unique_lock lock(mutex_);
+    done_.wait(lock, [this]() { return busy_workers_ == 0; });
+    job_ = nullptr;
+    if (exception_)
+    {
+      std::rethrow_exception(exception_);
+    }
+  }
+
+  /// Return the pool used by the parallel loops.
+  /**
+   * @return The global thread pool, whose size is the number of hardware threads.
+   */
+  static thread_pool& global()
+  {
+    static thread_pool pool;
+    return pool;
+  }
+
+private:
+  /// Queue of the consecutive tasks [begin, end) owned by one thread. Both bounds are packed into one atomic word,
+  /// thus the owner and stealing threads can modify the queue without locks.
+  struct alignas(64) task_queue
+  {
+    std::atomic<uint64_t> range_ = 0;
+
+    static uint64_t pack(uint64_t begin, uint64_t end) { return begin | (end << 32); }
+
+    /// Replaces the tasks of the queue. Must only be called by the owner or while no thread executes tasks.
+    void assign(size_t begin, size_t end)
+    {
+      range_.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    /// Takes the first task of the queue.
+    /**
+     * @param task Receives the task number.
+     * @return False, if the queue is empty.
+     */
+    bool pop_front(size_t& task)
+    {
+      uint64_t range = range_.load(std::memory_order_relaxed);
+      for (;;)
+      {
+        uint64_t begin = range & 0xffffffff, end = range >> 32;
+        if (begin >= end)
+        {
+          return false;
+        }
+        if (range_.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_relaxed))
+        {
+          task = begin;
+          return true;
+        }
+      }
+    }
+
+    /// Takes the back half of the tasks of the queue.
+    /**
+     * @param begin Receives the first stolen task.
+     * @param end Receives the end of the stolen tasks.
+     * @return False, if the queue is empty.
+     */
+    bool steal_back(size_t& begin, size_t& end)
+    {
+      uint64_t range = range_.load(std::memory_order_relaxed);
+      for (;;)
+      {
+        uint64_t first = range & 0xffffffff, last = range >> 32;
+        if (first >= last)
+        {
+          return false;
+        }
+        uint64_t middle = last - (last - first + 1) / 2;
+        if (range_.compare_exchange_weak(range, pack(first, middle), std::memory_order_relaxed))
+        {
+          begin = middle;
+          end = last;
+          return true;
+        }
+      }
+    }
+  };
+
+  /// Return, whether the current thread executes tasks, i.e. is a worker thread or a thread inside of `run`.
+  static bool& is_executing_task()
+  {
+    thread_local bool is_executing = false;
+    return is_executing;
+  }
+
+  /// Executes tasks of the current job until no thread has tasks left in its queue.
+  /**
+   * @param queue Index of the queue owned by the calling thread.
+   */
+  void execute(size_t queue)
+  {
+    const size_t n = size();
+    for (;;)
+    {
+      size_t task;
+      while (!cancelled_.load(std::memory_order_relaxed) && queues_[queue].pop_front(task))
+      {
+        try
+        {
+          invoke_(job_, task);
+        }
+        catch (...)
+        {
+          std::lock_guard lock(mutex_);
+          if (!exception_)
+          {
+            exception_ = std::current_exception();
+          }
+          cancelled_ = true;
+        }
+      }
+      if (cancelled_.load(std::memory_order_relaxed))
+      {
+        return;
+      }
+      size_t begin = 0, end = 0;
+      size_t victim = 1;
+      for (; victim < n && !queues_[(queue + victim) % n].steal_back(begin, end); ++victim)
+        ;
+      if (victim == n)
+      {
+        return;
+      }
+      queues_[queue].assign(begin, end);
+    }
+  }
+
+  /// Main function of a worker thread.
+  /**
+   * @param queue Index of the queue owned by the worker thread.
+   */
+  void work(size_t queue)
+  {
+    is_executing_task() = true;
+    size_t generation = 0;
+    for (;;)
+    {
+      {
+        std::unique_lock lock(mutex_);
+        wake_.wait(lock, [&]() { return stop_ || generation_ != generation; });
+        if (stop_)
+        {
+          return;
+        }
+        generation = generation_;
+      }
+      execute(queue);
+      {
+        std::lock_guard lock(mutex_);
+        --busy_workers_;
+      }
+      done_.notify_one();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::unique_ptr<task_queue[]> queues_;
+  std::mutex run_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  void* job_ = nullptr;
+  void (*invoke_)(void*, size_t) = nullptr;
+  std::atomic<bool> cancelled_ = false;
+  size_t busy_workers_ = 0;
+  size_t generation_ = 0;
+  std::exception_ptr exception_;
+  bool stop_ = false;
+};
+
+/**
+ * Returns the size of the chunks, into which an iteration range is split. The size is a multiple of `SimdSize`.
+ * @tparam SimdSize Vector size.
+ * @param range_size Size of the iteration range.
+ * @param chunk_size Requested size of the chunks or 0 for a size, which results in about 16 chunks per thread.
+ * @param thread_count Number of threads.
+ * @return The size of the chunks.
+ */
+template<int SimdSize>
+inline size_t parallel_chunk_size(size_t range_size, size_t chunk_size, unsigned thread_count)
+{
+  if (chunk_size == 0)
+  {
+    chunk_size = (range_size + 16 * thread_count - 1) / (16 * thread_count);
+  }
+  chunk_size = std::max(chunk_size, (range_size + thread_pool::max_task_count() - 1) / thread_pool::max_task_count());
+  return std::max<size_t>((chunk_size + SimdSize - 1) / SimdSize, 1) * SimdSize;
+}
+
+/**
+ * Splits the range [0, range_size) into chunks and calls a function for every chunk in parallel.
+ * @tparam SimdSize Vector size.
+ * @param pool Thread pool executing the chunks.
+ * @param range_size Size of the iteration range.
+ * @param chunk_size Requested size of the chunks (see `parallel_chunk_size`).
+ * @param fn Function called with the begin and the end of a chunk.
+ */
+template<int SimdSize>
+inline void parallel_chunks(thread_pool& pool, size_t range_size, size_t chunk_size, auto&& fn)
+{
+  chunk_size = parallel_chunk_size<SimdSize>(range_size, chunk_size, pool.size());
+  pool.run((range_size + chunk_size - 1) / chunk_size, [&](size_t chunk)
+    {
+      fn(chunk * chunk_size, std::min(range_size, (chunk + 1) * chunk_size));
+    });
+}
+
+/**
+ * Linear simd-ized iteration over a function using multiple threads. The range is split into chunks, whose sizes are
+ * multiples of `SimdSize`, and each chunk is iterated by `loop`. Thus, the function is called with the same indices
+ * as by `loop`, but in an unspecified order and concurrently.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param pool Thread pool executing the chunks.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param fn Generic function to be called (see `loop`). It must be safe to call it concurrently.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ * @param chunk_size Number of iterations executed by a task. It is rounded up to a multiple of `SimdSize`.
+ *   Defaults to 0, which results in about 16 tasks per thread.
+ */
+template<int SimdSize, auto ... Args, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop(thread_pool& pool, std::integral auto start, std::integral auto end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  if (!(IndexType(start) < IndexType(end)))
+  {
+    return;
+  }
+  parallel_chunks<SimdSize>(pool, size_t(IndexType(end) - IndexType(start)), chunk_size,
+    [&](size_t chunk_begin, size_t chunk_end)
+    {
+      loop<SimdSize, Args...>(IndexType(start) + IndexType(chunk_begin), IndexType(start) + IndexType(chunk_end), fn,
+        residualLoopPolicy);
+    });
+}
+
+/**
+ * Linear simd-ized iteration over a function using the threads of the global thread pool (see above).
+ */
+template<int SimdSize, auto ... Args, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop(std::integral auto start, std::integral auto end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  parallel_loop<SimdSize, Args...>(thread_pool::global(), start, end, fn, residualLoopPolicy, chunk_size);
+}
+
+/**
+ * Linear simd-ized reduction of the results of a function using multiple threads (see `loop_reduce`). Every chunk is
+ * reduced into a partial result by one thread, the partial results are combined in the order of the chunks. Thus, the
+ * result doesn't depend on the scheduling of the chunks.
+ * @tparam SimdSize Vector size.
+ * @tparam AccumulatorCount Number of independent accumulators of a chunk (see `loop_reduce`).
+ * @param pool Thread pool executing the chunks.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param init Initial value of the result.
+ * @param fn Generic function to be called (see `loop_reduce`). It must be safe to call it concurrently.
+ * @param op Associative and commutative binary operation (see `loop_reduce`).
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ * @param chunk_size Number of iterations executed by a task. It is rounded up to a multiple of `SimdSize`.
+ *   Defaults to 0, which results in about 16 tasks per thread.
+ * @return The result of `op` applied to `init` and the results of all iterations.
+ */
+template<int SimdSize, int AccumulatorCount = 1, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline auto parallel_loop_reduce(thread_pool& pool, std::integral auto start, std::integral auto end,
+  const auto& init, auto&& fn, auto&& op, ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop,
+  size_t chunk_size = 0)
+{
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  using ResultType = std::remove_cvref_t<decltype(init)>;
+  ResultType result(init);
+  if (!(IndexType(start) < IndexType(end)))
+  {
+    return result;
+  }
+  size_t range_size = size_t(IndexType(end) - IndexType(start));
+  chunk_size = parallel_chunk_size<SimdSize>(range_size, chunk_size, pool.size());
+  std::vector<std::optional<ResultType>> partial_results((range_size + chunk_size - 1) / chunk_size);
+  parallel_chunks<SimdSize>(pool, range_size, chunk_size, [&](size_t chunk_begin, size_t chunk_end)
+    {
+      partial_results[chunk_begin / chunk_size] = reduce_range<SimdSize, AccumulatorCount>(
+        IndexType(start) + IndexType(chunk_begin), IndexType(start) + IndexType(chunk_end), result, fn, op,
+        residualLoopPolicy);
+    });
+  for (const auto& partial_result : partial_results)
+  {
+    if (partial_result)
+    {
+      result = ResultType(op(result, *partial_result));
+    }
+  }
+  return result;
+}
+
+/**
+ * Linear simd-ized reduction using the threads of the global thread pool (see above).
+ */
+template<int SimdSize, int AccumulatorCount = 1, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline auto parallel_loop_reduce(std::integral auto start, std::integral auto end, const auto& init, auto&& fn,
+  auto&& op, ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  return parallel_loop_reduce<SimdSize, AccumulatorCount>(thread_pool::global(), start, end, init, fn, op,
+    residualLoopPolicy, chunk_size);
+}
+
+/**
+ * Simd-ized iteration over a function using indirect indexing and multiple threads. The range of indices is split
+ * into chunks, whose sizes are multiples of `SimdSize`, and each chunk is iterated by `loop`. The chunks are
+ * scheduled by work stealing, thus iterations of different costs are balanced between the threads.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @tparam IteratorType Deduced type of the random access iterator defining the range of indices.
+ * @param pool Thread pool executing the chunks.
+ * @param start Inclusive start of the range of indices.
+ * @param end Exclusive end of the range of indices.
+ * @param fn Generic function to be called (see `loop`). It must be safe to call it concurrently.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ * @param chunk_size Number of iterations executed by a task. It is rounded up to a multiple of `SimdSize`.
+ *   Defaults to 0, which results in about 16 tasks per thread.
+ */
+template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
+  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop(thread_pool& pool, IteratorType start, const IteratorType& end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  if (!(start < end))
+  {
+    return;
+  }
+  parallel_chunks<SimdSize>(pool, size_t(end - start), chunk_size, [&](size_t chunk_begin, size_t chunk_end)
+    {
+      using DifferenceType = std::iter_difference_t<IteratorType>;
+      loop<SimdSize, Args...>(start + DifferenceType(chunk_begin), start + DifferenceType(chunk_end), fn,
+        residualLoopPolicy);
+    });
+}
+
+/**
+ * Simd-ized iteration over a function using indirect indexing and the threads of the global thread pool (see above).
+ */
+template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
+  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop(IteratorType start, const IteratorType& end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  parallel_loop<SimdSize, Args...>(thread_pool::global(), start, end, fn, residualLoopPolicy, chunk_size);
+}
+
+/**
+ * Simd-ized iteration over a function using indirect indexing and multiple threads. The range of indices is split
+ * into chunks, whose sizes are multiples of `SimdSize`, and each chunk is iterated by `loop_with_linear_index`. The
+ * linear index passed to the function is relative to `start` of the whole range. The chunks are scheduled by work
+ * stealing, thus iterations of different costs are balanced between the threads.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @tparam IteratorType Deduced type of the random access iterator defining the range of indices.
+ * @param pool Thread pool executing the chunks.
+ * @param start Inclusive start of the range of indices.
+ * @param end Exclusive end of the range of indices.
+ * @param fn Generic function to be called (see `loop_with_linear_index`). It must be safe to call it concurrently.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop_with_linear_index`).
+ * @param chunk_size Number of iterations executed by a task. It is rounded up to a multiple of `SimdSize`.
+ *   Defaults to 0, which results in about 16 tasks per thread.
+ */
+template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
+  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop_with_linear_index(thread_pool& pool, IteratorType start, const IteratorType& end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  if (!(start < end))
+  {
+    return;
+  }
+  parallel_chunks<SimdSize>(pool, size_t(end - start), chunk_size, [&](size_t chunk_begin, size_t chunk_end)
+    {
+      using DifferenceType = std::iter_difference_t<IteratorType>;
+      loop_with_linear_index<SimdSize, Args...>(start + DifferenceType(chunk_begin),
+        start + DifferenceType(chunk_end), shift_linear_index(fn, chunk_begin), residualLoopPolicy);
+    });
+}
+
+/**
+ * Simd-ized iteration over a function using indirect indexing and the threads of the global thread pool (see above).
+ */
+template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
+  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void parallel_loop_with_linear_index(IteratorType start, const IteratorType& end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, size_t chunk_size = 0)
+{
+  parallel_loop_with_linear_index<SimdSize, Args...>(thread_pool::global(), start, end, fn, residualLoopPolicy,
+    chunk_size);
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_PARALLEL_LOOP
@@ -0,0 +1,74 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief A view of a quantized array, whose elements are accessed as dequantized values.
+ */
+
+#ifndef SIMD_ACCESS_QUANTIZED_VIEW
+#define SIMD_ACCESS_QUANTIZED_VIEW
+
+#include <concepts>
+#include <cstddef>
+
+#include "simd_access/encoding.hpp"
+#include "simd_access/simd_access.hpp"
+
+namespace simd_access
+{
+
+/// View of an array of integral values, which are quantized by a scale and an offset (see `linear_quantization`).
+/**
+ * `SIMD_ACCESS(view, i)` loads the stored values and dequantizes them in registers to a simd value of `ComputeType`,
+ * i.e. no dequantized copy of the array is needed. Assignments quantize with saturation. Scalar accesses (`view[i]`)
+ * return a `converting_reference`.
+ * @tparam StoredType Integral type of the stored values, e.g. `std::int8_t` or `std::uint16_t`.
+ * @tparam ComputeType Floating point type of the dequantized values.
+ */
+template<std::integral StoredType, class ComputeType = float>
+struct quantized_view
+{
+  static constexpr bool has_custom_layout = true;
+  using value_type = StoredType;
+
+  /// Pointer to the first stored value.
+  StoredType* data_;
+  /// Number of elements.
+  size_t size_;
+  /// Scale and offset of the quantization.
+  linear_quantization<ComputeType> quantization_;
+
+  /// Return the number of elements.
+  size_t size() const { return size_; }
+
+  /// Return a reference to an element, which converts to and is assignable from `ComputeType`.
+  auto operator[](size_t i) const
+  {
+    return as<ComputeType>(data_[i], quantization_);
+  }
+
+  /// Return the simd access to the elements of a simd index. Called by `SIMD_ACCESS`.
+  auto simd_subobject(const auto& indices) const
+  {
+    return as<ComputeType>(LValueSeparator<true>::to_simd(data_, indices), quantization_);
+  }
+};
+
+/**
+ * Creates a view of a quantized array.
+ * @tparam ComputeType Floating point type of the dequantized values.
+ * @param data Pointer to the first stored value.
+ * @param size Number of elements.
+ * @param scale Distance of the values represented by consecutive stored values.
+ * @param offset Value represented by a stored zero.
+ * @return The view.
+ */
+template<class ComputeType = float, std::integral StoredType>
+inline auto make_quantized_view(StoredType* data, size_t size, ComputeType scale, ComputeType offset = ComputeType(0))
+{
+  return quantized_view<StoredType, ComputeType>{data, size, {scale, offset}};
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_QUANTIZED_VIEW
@@ -14,10 +14,15 @@
 #ifndef SIMD_REFLECTION
 #define SIMD_REFLECTION
 
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "simd_access/base.hpp"
+#include "simd_access/intrinsics.hpp"
 #include "simd_access/location.hpp"
 #include "simd_access/index.hpp"
 
@@ -89,6 +94,132 @@ inline void simd_members(std::pair<DestType1, DestType2>& d, const std::pair<Src
 }
 
 
+/**
+ * Checks, whether `SimdSize` consecutive objects of type `T` can be loaded and stored by transposing them in
+ * registers. This requires a trivially copyable `T`, whose size is a multiple of its alignment. The alignment is the
+ * size of the transposed elements.
+ */
+template<class T, int SimdSize>
+concept has_interleaved_access =
+  std::is_trivially_copyable_v<T> && !std::is_void_v<bits_type<alignof(T)>> &&
+  has_native_interleaved_access<int(sizeof(T) / alignof(T)), bits_type<alignof(T)>, SimdSize>;
+
+/**
+ * Returns the position of a member in a structure, which is transposed as a sequence of elements of the size of its
+ * alignment.
+ * @tparam SimdSize Vector size of the simd type.
+ * @param base Address of the scalar structure.
+ * @param scalar Reference to the scalar member.
+ * @param simd Reference to the corresponding simd member.
+ * @return The index of the member in the sequence of elements or -1, if it doesn't match an element.
+ */
+template<int SimdSize, class T, class ScalarType, class SimdType>
+inline int interleaved_slot(const T* base, const ScalarType& scalar, const SimdType&)
+{
+  if constexpr (sizeof(ScalarType) == alignof(T) &&
+                std::is_same_v<SimdType, stdx::fixed_size_simd<ScalarType, SimdSize>>)
+  {
+    auto offset = reinterpret_cast<const char*>(&scalar) - reinterpret_cast<const char*>(base);
+    if (offset >= 0 && offset < std::ptrdiff_t(sizeof(T)) && offset % std::ptrdiff_t(alignof(T)) == 0)
+    {
+      return int(offset / std::ptrdiff_t(alignof(T)));
+    }
+  }
+  return -1;
+}
+
+/**
+ * Checks, whether the members iterated by `simd_members` cover all elements of a transposed structure exactly once.
+ * The check is usually evaluated at compile time.
+ * @param d Destination argument of `simd_members`.
+ * @param s Source argument of `simd_members`.
+ * @param slot_of Functor returning the position of a member pair as returned by `interleaved_slot`.
+ * @return True, if the structure can be transposed.
+ */
+template<class T, class DestType, class SrcType, class FN>
+inline bool is_interleaved_layout(DestType& d, const SrcType& s, FN&& slot_of)
+{
+  constexpr int pitch = int(sizeof(T) / alignof(T));
+  std::uint32_t covered = 0;
+  bool is_interleavable = true;
+  simd_members(d, s, [&](auto&& dest, auto&& src)
+    {
+      int slot = slot_of(dest, src);
+      is_interleavable = is_interleavable && slot >= 0 && (covered & (1u << slot)) == 0;
+      covered |= slot >= 0 ? 1u << slot : 0u;
+    });
+  return is_interleavable && covered == (1u << pitch) - 1;
+}
+
+/**
+ * Loads a structure-of-simd value from `SimdSize` consecutive objects by loading whole vectors and transposing them
+ * with shuffle instructions. This is only possible, if the members of `result` cover the scalar structure completely
+ * and all members have the same size as the alignment of `T`.
+ * @tparam SimdSize Vector size of the simd type.
+ * @tparam T Deduced type of the scalar structure.
+ * @tparam SimdType Deduced structure-of-simd type.
+ * @param base Address of the first scalar object.
+ * @param result The structure-of-simd value to be loaded.
+ * @return True, if the value was loaded, false if the structure layout doesn't permit a transposing load.
+ */
+template<int SimdSize, class T, class SimdType>
+inline bool interleaved_load(const T* base, SimdType& result)
+{
+  using element_type = bits_type<alignof(T)>;
+  constexpr int pitch = int(sizeof(T) / alignof(T));
+  auto slot_of = [&](const auto& dest, const auto& src) { return interleaved_slot<SimdSize>(base, src, dest); };
+  if (!is_interleaved_layout<T>(result, *base, slot_of))
+  {
+    return false;
+  }
+
+  auto vectors = native_deinterleaved_load<pitch, element_type, SimdSize>(reinterpret_cast<const element_type*>(base));
+  simd_members(result, *base, [&](auto&& dest, auto&& src)
+    {
+      if constexpr (sizeof(src) == sizeof(element_type))
+      {
+        using simd_type = std::remove_cvref_t<decltype(dest)>;
+        using vector_type = vector_extension_t<typename simd_type::value_type, SimdSize>;
+        dest = from_native<simd_type>(std::bit_cast<vector_type>(vectors[slot_of(dest, src)]));
+      }
+    });
+  return true;
+}
+
+/**
+ * Stores a structure-of-simd value to `SimdSize` consecutive objects by interleaving the simd members with shuffle
+ * instructions and storing whole vectors. This is only possible, if the simd members of `source` cover the scalar
+ * structure completely and all members have the same size as the alignment of `T`.
+ * @tparam SimdSize Vector size of the simd type.
+ * @tparam T Deduced type of the scalar structure.
+ * @tparam SimdType Deduced structure-of-simd type.
+ * @param base Address of the first scalar object.
+ * @param source The structure-of-simd value.
+ * @return True, if the value was stored, false if the structure layout doesn't permit an interleaving store.
+ */
+template<int SimdSize, class T, class SimdType>
+inline bool interleaved_store(T* base, const SimdType& source)
+{
+  using element_type = bits_type<alignof(T)>;
+  constexpr int pitch = int(sizeof(T) / alignof(T));
+  auto slot_of = [&](const auto& dest, const auto& src) { return interleaved_slot<SimdSize>(base, dest, src); };
+  if (!is_interleaved_layout<T>(*base, source, slot_of))
+  {
+    return false;
+  }
+
+  std::array<vector_extension_t<element_type, SimdSize>, pitch> vectors;
+  simd_members(*base, source, [&](auto&& dest, auto&& src)
+    {
+      if constexpr (sizeof(dest) == sizeof(element_type))
+      {
+        vectors[slot_of(dest, src)] = to_native<vector_extension_t<element_type, SimdSize>>(src);
+      }
+    });
+  native_interleaved_store<pitch, element_type, SimdSize>(reinterpret_cast<element_type*>(base), vectors);
+  return true;
+}
+
 /**
  * Loads a structure-of-simd value from a memory location defined by a base address and an linear index. The simd
  * elements to be loaded are located at the positions base, base+ElementSize, base+2*ElementSize, ...
@@ -104,6 +235,13 @@ template<size_t ElementSize, class T, int SimdSize>
 inline auto load(const linear_location<T, SimdSize>& location)
 {
   auto result = simdized_value<SimdSize>(*location.base_);
+  if constexpr (ElementSize == sizeof(T) && has_interleaved_access<T, SimdSize>)
+  {
+    if (interleaved_load<SimdSize>(location.base_, result))
+    {
+      return result;
+    }
+  }
   simd_members(result, *location.base_, [&](auto&& dest, auto&& src)
     {
       dest = load<ElementSize>(linear_location<std::remove_reference_t<decltype(src)>, SimdSize>(&src));
@@ -128,10 +266,13 @@ inline auto load_rvalue(auto&& base, const auto& idx, auto&& subobject)
   decltype(simdized_value<idx.size()>(std::declval<BaseType>())) result;
   for (decltype(idx.size()) i = 0, e = idx.size(); i < e; ++i)
   {
-    simd_members(result, subobject(base[get_index(idx, i)]), [&](auto&& dest, auto&& src)
-      {
-        dest[i] = src;
-      });
+    if (is_active_lane(idx, i))
+    {
+      simd_members(result, subobject(base[get_index(idx, i)]), [&](auto&& dest, auto&& src)
+        {
+          dest[i] = src;
+        });
+    }
   }
   return result;
 }
@@ -151,10 +292,13 @@ inline auto load_rvalue(auto&& base, const auto& idx)
   decltype(simdized_value<idx.size()>(std::declval<BaseType>())) result;
   for (decltype(idx.size()) i = 0, e = idx.size(); i < e; ++i)
   {
-    simd_members(result, base[get_index(idx, i)], [&](auto&& dest, auto&& src)
-      {
-        dest[i] = src;
-      });
+    if (is_active_lane(idx, i))
+    {
+      simd_members(result, base[get_index(idx, i)], [&](auto&& dest, auto&& src)
+        {
+          dest[i] = src;
+        });
+    }
   }
   return result;
 }
@@ -175,6 +319,13 @@ template<size_t ElementSize, class T, class ExprType, int SimdSize>
 inline void store(const linear_location<T, SimdSize>& location, const ExprType& expr)
 {
   const decltype(simdized_value<SimdSize>(std::declval<T>()))& source = expr;
+  if constexpr (ElementSize == sizeof(T) && has_interleaved_access<T, SimdSize>)
+  {
+    if (interleaved_store<SimdSize>(location.base_, source))
+    {
+      return;
+    }
+  }
   simd_members(*location.base_, source, [&](auto&& dest, auto&& src)
     {
       store<ElementSize>(
@@ -229,6 +380,158 @@ inline void store(const indexed_location<T, SimdSize, IndexArray>& location, con
     });
 }
 
+/**
+ * Loads the active lanes of a structure-of-simd value from a memory location defined by a base address, a linear
+ * index and a mask. The structure is loaded member by member.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of the scalar structure, of which `SimdSize` number of objects will be combined in a
+ *   structure-of-simd.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address of the memory location, at which the first scalar element is stored, and the mask.
+ * @return A simd value.
+ */
+template<size_t ElementSize, class T, int SimdSize, class MaskType>
+  requires (!simd_arithmetic<T>)
+inline auto load(const masked_location<linear_location<T, SimdSize>, MaskType>& location)
+{
+  auto result = simdized_value<SimdSize>(*location.location_.base_);
+  simd_members(result, *location.location_.base_, [&](auto&& dest, auto&& src)
+    {
+      using member_location = linear_location<std::remove_reference_t<decltype(src)>, SimdSize>;
+      dest = load<ElementSize>(masked_location<member_location, MaskType>{member_location{&src}, location.mask_});
+    });
+  return result;
+}
+
+/**
+ * Stores the active lanes of a structure-of-simd value to a memory location defined by a base address, a linear
+ * index and a mask. The structure is stored member by member.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of the scalar structure, of which `SimdSize`number of objects are combined in a
+ *   structure-of-simd.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam ExprType Deduced type of the source expression.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address of the memory location, at which the first scalar element is stored, and the mask.
+ * @param expr The expression, whose result is stored. Must be convertible to a structure-of-simd.
+ */
+template<size_t ElementSize, class T, class ExprType, int SimdSize, class MaskType>
+  requires (!simd_arithmetic<T>)
+inline void store(const masked_location<linear_location<T, SimdSize>, MaskType>& location, const ExprType& expr)
+{
+  const decltype(simdized_value<SimdSize>(std::declval<T>()))& source = expr;
+  simd_members(*location.location_.base_, source, [&](auto&& dest, auto&& src)
+    {
+      using member_location = linear_location<std::remove_reference_t<decltype(dest)>, SimdSize>;
+      store<ElementSize>(masked_location<member_location, MaskType>{member_location{&dest}, location.mask_}, src);
+    });
+}
+
+/**
+ * Loads the active lanes of a structure-of-simd value from a memory location defined by a base address, an indirect
+ * index and a mask. The structure is loaded member by member.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of the scalar structure, of which `SimdSize` number of objects will be combined in a
+ *   structure-of-simd.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam IndexArray Deduced type of the array storing the indices.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address, indices and mask of the memory location.
+ * @return A simd value.
+ */
+template<size_t ElementSize, class T, int SimdSize, class IndexArray, class MaskType>
+  requires (!simd_arithmetic<T>)
+inline auto load(const masked_location<indexed_location<T, SimdSize, IndexArray>, MaskType>& location)
+{
+  const auto& indexed = location.location_;
+  auto result = simdized_value<SimdSize>(*indexed.base_);
+  simd_members(result, *indexed.base_, [&](auto&& dest, auto&& src)
+    {
+      using member_location = indexed_location<std::remove_reference_t<decltype(src)>, SimdSize, IndexArray>;
+      dest = load<ElementSize>(
+        masked_location<member_location, MaskType>{member_location{&src, indexed.indices_}, location.mask_});
+    });
+  return result;
+}
+
+/**
+ * Stores the active lanes of a structure-of-simd value to a memory location defined by a base address, an indirect
+ * index and a mask. The structure is stored member by member.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam T Deduced type of the scalar structure, of which `SimdSize`number of objects are combined in a
+ *   structure-of-simd.
+ * @tparam SimdSize Deduced vector size of the simd type.
+ * @tparam IndexArray Deduced type of the array storing the indices.
+ * @tparam ExprType Deduced type of the source expression.
+ * @tparam MaskType Deduced type of the simd mask.
+ * @param location Address, indices and mask of the memory location.
+ * @param expr The expression, whose result is stored. Must be convertible to a structure-of-simd.
+ */
+template<size_t ElementSize, class T, class ExprType, int SimdSize, class IndexArray, class MaskType>
+  requires (!simd_arithmetic<T>)
+inline void store(const masked_location<indexed_location<T, SimdSize, IndexArray>, MaskType>& location,
+  const ExprType& expr)
+{
+  const auto& indexed = location.location_;
+  const decltype(simdized_value<SimdSize>(std::declval<T>()))& source = expr;
+  simd_members(*indexed.base_, source, [&](auto&& dest, auto&& src)
+    {
+      using member_location = indexed_location<std::remove_reference_t<decltype(dest)>, SimdSize, IndexArray>;
+      store<ElementSize>(
+        masked_location<member_location, MaskType>{member_location{&dest, indexed.indices_}, location.mask_}, src);
+    });
+}
+
+/**
+ * Loads a structure-of-simd value of a compute structure type (e.g. `Particle<double>`) from structures stored in a
+ * compact type (e.g. `Particle<float>`). The stored structures are loaded by the underlying location, i.e. transposed
+ * in registers if possible, and every member is widened by `Encoding`. The members iterated by `simd_members` for
+ * the compute type and the stored type must correspond.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the location of the stored structures.
+ * @tparam ComputeType Deduced scalar structure type, in which the values are computed.
+ * @tparam Encoding Deduced conversion between the stored members and the members of `ComputeType`.
+ * @param location The converting location.
+ * @return A structure-of-simd value of `ComputeType`.
+ */
+template<size_t ElementSize, class Location, class ComputeType, class Encoding>
+  requires (!simd_arithmetic<ComputeType>)
+inline auto load(const converting_location<Location, ComputeType, Encoding>& location)
+{
+  auto result = simdized_value<location_simd_size<Location>>(ComputeType());
+  simd_members(result, load<ElementSize>(location.location_), [&](auto&& dest, auto&& src)
+    {
+      location.encoding_.decode(dest, src);
+    });
+  return result;
+}
+
+/**
+ * Stores a structure-of-simd value of a compute structure type to structures stored in a compact type. Every member
+ * is narrowed by `Encoding` and the stored structures are written by the underlying location.
+ * @tparam ElementSize Size in bytes of the type of the simd-indexed element.
+ * @tparam Location Deduced type of the location of the stored structures.
+ * @tparam ComputeType Deduced scalar structure type, in which the values are computed.
+ * @tparam Encoding Deduced conversion between the stored members and the members of `ComputeType`.
+ * @tparam ExprType Deduced type of the source expression.
+ * @param location The converting location.
+ * @param expr The expression, whose result is stored. Must be convertible to a structure-of-simd of `ComputeType`.
+ */
+template<size_t ElementSize, class Location, class ComputeType, class Encoding, class ExprType>
+  requires (!simd_arithmetic<ComputeType>)
+inline void store(const converting_location<Location, ComputeType, Encoding>& location, const ExprType& expr)
+{
+  constexpr int simd_size = location_simd_size<Location>;
+  const decltype(simdized_value<simd_size>(std::declval<ComputeType>()))& source = expr;
+  auto stored = simdized_value<simd_size>(std::remove_const_t<typename Location::value_type>());
+  simd_members(stored, source, [&](auto&& dest, auto&& src)
+    {
+      location.encoding_.encode(dest, src);
+    });
+  store<ElementSize>(location.location_, stored);
+}
+
 /**
  * Returns a `where_expression` for structure-of-simd types, which are unsupported by stdx::simd.
  * @tparam MASK Deduced type of the simd mask.
@@ -0,0 +1,89 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief A multi-dimensional view of a contiguous array in row-major order.
+ */
+
+#ifndef SIMD_ACCESS_ROW_MAJOR_VIEW
+#define SIMD_ACCESS_ROW_MAJOR_VIEW
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+
+namespace simd_access
+{
+
+/// Multi-dimensional view of a contiguous array, whose last dimension is contiguous (row-major order).
+/**
+ * `view[k][j][i]` accesses the element at `data_[k * strides_[0] + j * strides_[1] + i]`. Thus, accesses via an
+ * `index_nd` (see `loop_nd`) compute the offset of the row and access the row by the index in the last dimension.
+ * @tparam T Element type.
+ * @tparam Rank Number of dimensions.
+ */
+template<class T, size_t Rank>
+struct row_major_view
+{
+  static_assert(Rank > 0);
+
+  /// Pointer to the first element.
+  T* data_;
+  /// Number of elements in the first dimension.
+  size_t size_;
+  /// Distances of consecutive rows in the dimensions `[0, Rank - 1)` in elements.
+  std::array<size_t, Rank - 1> strides_;
+
+  /// Return the number of elements in the first dimension.
+  size_t size() const { return size_; }
+
+  /// Return the sub-view of a row in the first dimension or, if `Rank` is 1, the element.
+  /**
+   * @param i Index in the first dimension.
+   * @return A `row_major_view<T, Rank - 1>` or a reference to the element.
+   */
+  decltype(auto) operator[](size_t i) const
+  {
+    if constexpr (Rank == 1)
+    {
+      return data_[i];
+    }
+    else
+    {
+      row_major_view<T, Rank - 1> result{data_ + i * strides_[0], 0, {}};
+      std::copy(strides_.begin() + 1, strides_.end(), result.strides_.begin());
+      result.size_ = Rank == 2 ? strides_[0] : strides_[0] / strides_[1];
+      return result;
+    }
+  }
+};
+
+/**
+ * Creates a multi-dimensional view of a contiguous array in row-major order.
+ * @param data Pointer to the first element.
+ * @param size Number of elements in the first dimension.
+ * @param extents Number of elements in the other dimensions.
+ * @return The view.
+ */
+template<class T>
+inline auto make_row_major_view(T* data, std::integral auto size, std::integral auto... extents)
+{
+  constexpr size_t rank = sizeof...(extents) + 1;
+  row_major_view<T, rank> result{data, size_t(size), {}};
+  if constexpr (rank > 1)
+  {
+    const std::array<size_t, rank - 1> inner_extents{size_t(extents)...};
+    size_t stride = 1;
+    for (size_t dim = rank - 1; dim-- > 0;)
+    {
+      stride *= inner_extents[dim];
+      result.strides_[dim] = stride;
+    }
+  }
+  return result;
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_ROW_MAJOR_VIEW
@@ -9,6 +9,8 @@
 #define SIMD_ACCESS_MAIN
 
 #include <concepts>
+#include <type_traits>
+#include <utility>
 
 #include "simd_access/base.hpp"
 #include "simd_access/element_access.hpp"
@@ -22,6 +24,43 @@
 namespace simd_access
 {
 
+/**
+ * Checks, whether a container provides the simd accesses to its elements itself (e.g. `soa_vector`) instead of the
+ * default accesses via the addresses of its elements. Such a container provides the member functions
+ * `scalar_subobject(i, subobject)` and `simd_subobject(indices, subobject...)`.
+ */
+template<class T>
+concept has_custom_layout = std::remove_cvref_t<T>::has_custom_layout;
+
+/**
+ * Returns the type of an element of `base`, which is used by the `SIMD_ACCESS` macro to determine the type of the
+ * accessed subobject. Only used in unevaluated contexts.
+ */
+template<class T>
+auto element_reference(T&& base) -> decltype(std::forward<T>(base)[0]);
+
+/**
+ * Returns a reference to the element type of a container with custom layout, whose `operator[]` might return a proxy.
+ * Only used in unevaluated contexts.
+ */
+template<has_custom_layout T>
+auto element_reference(T&& base) -> std::conditional_t<std::is_const_v<std::remove_reference_t<T>>,
+  const typename std::remove_cvref_t<T>::value_type&, typename std::remove_cvref_t<T>::value_type&>;
+
+/**
+ * Returns the type of the element of `base` accessed by an index. Only used in unevaluated contexts.
+ */
+template<class T>
+auto element_reference(T&& base, const auto&) -> decltype(element_reference(std::forward<T>(base)));
+
+/**
+ * Returns the type of the element of a multi-dimensional array accessed by an `index_nd`, i.e. the type of an element
+ * of the accessed row. Only used in unevaluated contexts.
+ */
+template<class T, size_t Rank, class InnerIndexType, class IndexType>
+auto element_reference(T&& base, const index_nd<Rank, InnerIndexType, IndexType>& idx)
+  -> decltype(element_reference(idx.row(std::forward<T>(base))));
+
 template<bool isLvalue>
 struct LValueSeparator;
 
@@ -35,7 +74,14 @@ struct LValueSeparator<true>
 
   static decltype(auto) to_simd(auto&& base, std::integral auto i, auto&& subobject)
   {
-    return subobject(base[i]);
+    if constexpr (has_custom_layout<decltype(base)>)
+    {
+      return base.scalar_subobject(i, subobject);
+    }
+    else
+    {
+      return subobject(base[i]);
+    }
   }
 
   template<int SimdSize, class IndexType>
@@ -50,12 +96,36 @@ struct LValueSeparator<true>
     return &base_addr[0];
   }
 
+  template<int SimdSize, size_t Stride, class IndexType>
+  static auto get_base_address(auto&& base_addr, const strided_index<SimdSize, Stride, IndexType>& i)
+  {
+    return &base_addr[i.index_];
+  }
+
+  template<int SimdSize, class IndexType>
+  static auto get_base_address(auto&& base_addr, const runtime_strided_index<SimdSize, IndexType>& i)
+  {
+    return &base_addr[i.index_];
+  }
+
   template<int SimdSize, class ArrayType>
   static auto get_base_address(auto&& base_addr, const index_array<SimdSize, ArrayType>&)
   {
     return &base_addr[0];
   }
 
+  template<int SimdSize, class IndexType>
+  static auto get_base_address(auto&& base_addr, const masked_index<SimdSize, IndexType>& i)
+  {
+    return &base_addr[i.index_];
+  }
+
+  template<int SimdSize, class ArrayType>
+  static auto get_base_address(auto&& base_addr, const masked_index_array<SimdSize, ArrayType>&)
+  {
+    return &base_addr[0];
+  }
+
   template<int SimdSize, class IndexType>
   static auto get_base_address(auto&& base_addr, const index<SimdSize, IndexType>& i, auto&& subobject)
   {
@@ -68,12 +138,38 @@ struct LValueSeparator<true>
     return &subobject(base_addr[0]);
   }
 
+  template<int SimdSize, size_t Stride, class IndexType>
+  static auto get_base_address(auto&& base_addr, const strided_index<SimdSize, Stride, IndexType>& i,
+    auto&& subobject)
+  {
+    return &subobject(base_addr[i.index_]);
+  }
+
+  template<int SimdSize, class IndexType>
+  static auto get_base_address(auto&& base_addr, const runtime_strided_index<SimdSize, IndexType>& i,
+    auto&& subobject)
+  {
+    return &subobject(base_addr[i.index_]);
+  }
+
   template<int SimdSize, class ArrayType>
   static auto get_base_address(auto&& base_addr, const index_array<SimdSize, ArrayType>&, auto&& subobject)
   {
     return &subobject(base_addr[0]);
   }
 
+  template<int SimdSize, class IndexType>
+  static auto get_base_address(auto&& base_addr, const masked_index<SimdSize, IndexType>& i, auto&& subobject)
+  {
+    return &subobject(base_addr[i.index_]);
+  }
+
+  template<int SimdSize, class ArrayType>
+  static auto get_base_address(auto&& base_addr, const masked_index_array<SimdSize, ArrayType>&, auto&& subobject)
+  {
+    return &subobject(base_addr[0]);
+  }
+
 
   template<size_t ElementSize, class T, int SimdSize, class IndexType>
   static auto get_direct_value_access(T* base, const index<SimdSize, IndexType>&)
@@ -81,6 +177,30 @@ struct LValueSeparator<true>
     return make_value_access<ElementSize>(linear_location<T, SimdSize>{base});
   }
 
+  template<size_t ElementSize, class T, int SimdSize, class IndexType>
+  static auto get_direct_value_access(T* base, const streaming_index<SimdSize, IndexType>&)
+  {
+    return make_value_access<ElementSize>(streaming_location<linear_location<T, SimdSize>>{{base}});
+  }
+
+  template<size_t ElementSize, class T, int SimdSize, class IndexType>
+  static auto get_direct_value_access(T* base, const aligned_index<SimdSize, IndexType>&)
+  {
+    return make_value_access<ElementSize>(aligned_location<linear_location<T, SimdSize>>{{base}});
+  }
+
+  template<size_t ElementSize, class T, int SimdSize, size_t Stride, class IndexType>
+  static auto get_direct_value_access(T* base, const strided_index<SimdSize, Stride, IndexType>&)
+  {
+    return make_value_access<ElementSize * Stride>(linear_location<T, SimdSize>{base});
+  }
+
+  template<size_t ElementSize, class T, int SimdSize, class IndexType>
+  static auto get_direct_value_access(T* base, const runtime_strided_index<SimdSize, IndexType>& idx)
+  {
+    return make_value_access<ElementSize>(strided_location<T, SimdSize, IndexType>{base, idx.stride_});
+  }
+
   template<size_t ElementSize, class T, int SimdSize, class ArrayType>
   static auto get_direct_value_access(T* base, const index_array<SimdSize, ArrayType>& idx)
   {
@@ -93,11 +213,41 @@ struct LValueSeparator<true>
     return make_value_access<ElementSize>(indexed_location<T, idx.size(), stdx::simd<IndexType, Abi>>{base, idx});
   }
 
+  template<size_t ElementSize, class T, int SimdSize, class IndexType>
+  static auto get_direct_value_access(T* base, const masked_index<SimdSize, IndexType>& idx)
+  {
+    return make_value_access<ElementSize>(masked_location<linear_location<T, SimdSize>, decltype(idx.mask_)>{
+      linear_location<T, SimdSize>{base}, idx.mask_});
+  }
+
+  template<size_t ElementSize, class T, int SimdSize, class ArrayType>
+  static auto get_direct_value_access(T* base, const masked_index_array<SimdSize, ArrayType>& idx)
+  {
+    using location_type = indexed_location<T, SimdSize, ArrayType>;
+    return make_value_access<ElementSize>(masked_location<location_type, decltype(idx.mask_)>{
+      location_type{base, idx.index_}, idx.mask_});
+  }
+
   template<class IndexType, class... Func>
     requires(!std::integral<IndexType>)
   static auto to_simd(auto&& base, const IndexType& indices, Func&&... subobject)
   {
-    return get_direct_value_access<sizeof(decltype(base[0]))>(get_base_address(base, indices, subobject...), indices);
+    if constexpr (has_custom_layout<decltype(base)>)
+    {
+      return base.simd_subobject(indices, subobject...);
+    }
+    else
+    {
+      return get_direct_value_access<sizeof(decltype(base[0]))>(get_base_address(base, indices, subobject...),
+        indices);
+    }
+  }
+
+  template<size_t Rank, class InnerIndexType, class IndexType, class... Func>
+  static decltype(auto) to_simd(auto&& base, const index_nd<Rank, InnerIndexType, IndexType>& idx,
+    Func&&... subobject)
+  {
+    return to_simd(idx.row(base), idx.inner_, subobject...);
   }
 };
 
@@ -134,6 +284,13 @@ struct LValueSeparator<false>
   {
     return load_rvalue<BaseTypeFn<T, Func>>(base, idx, subelement);
   }
+
+  template<size_t Rank, class InnerIndexType, class IndexType, class... Func>
+  static decltype(auto) to_simd(auto&& base, const index_nd<Rank, InnerIndexType, IndexType>& idx,
+    Func&&... subobject)
+  {
+    return to_simd(idx.row(std::forward<decltype(base)>(base)), idx.inner_, subobject...);
+  }
 };
 
 
@@ -144,7 +301,7 @@ struct LValueSeparator<false>
 template<class T, class IndexType>
 inline decltype(auto) sa(T&& base, const IndexType& index)
 {
-  return LValueSeparator<std::is_lvalue_reference_v<decltype(base[0])>>::to_simd(base, index);
+  return LValueSeparator<std::is_lvalue_reference_v<decltype(element_reference(base, index))>>::to_simd(base, index);
 }
 
 template<has_to_simd T>
@@ -171,7 +328,8 @@ inline auto to_simd(T&& value)
  * be directly written.
  */
 #define SIMD_ACCESS(base, index, ...) \
-  simd_access::LValueSeparator<std::is_lvalue_reference_v<decltype((base[0] __VA_ARGS__))>>:: \
+  simd_access::LValueSeparator< \
+    std::is_lvalue_reference_v<decltype((simd_access::element_reference(base, index) __VA_ARGS__))>>:: \
     to_simd(base, index __VA_OPT__(, [&](auto&& e) -> decltype((e __VA_ARGS__)) { return e __VA_ARGS__; }))
 
 #define SIMD_ACCESS_V(...) simd_access::to_simd(SIMD_ACCESS(__VA_ARGS__))
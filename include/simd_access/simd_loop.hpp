@@ -8,38 +8,470 @@
 #ifndef SIMD_ACCESS_LOOP
 #define SIMD_ACCESS_LOOP
 
+#include <algorithm>
+#include <array>
 #include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <tuple>
 #include <type_traits>
+#include <utility>
 #include "simd_access/index.hpp"
+#include "simd_access/intrinsics.hpp"
+#include "simd_access/reflection.hpp"
 
 namespace simd_access
 {
 
 using ScalarResidualLoopT = std::integral_constant<int, 0>;
 using VectorResidualLoopT = std::integral_constant<int, 1>;
+using MaskedResidualLoopT = std::integral_constant<int, 2>;
 constexpr auto ScalarResidualLoop = ScalarResidualLoopT();
 constexpr auto VectorResidualLoop = VectorResidualLoopT();
+constexpr auto MaskedResidualLoop = MaskedResidualLoopT();
 
+/// Statistics of the chunks of indirect loops with the `ContiguityCheck` policy.
+struct contiguity_counter
+{
+  /// Number of chunks, whose indices are consecutive.
+  size_t contiguous_chunks_ = 0;
+  /// Number of checked chunks.
+  size_t chunks_ = 0;
+
+  /// Return the fraction of chunks, whose indices are consecutive.
+  double hit_rate() const { return chunks_ == 0 ? 0.0 : double(contiguous_chunks_) / double(chunks_); }
+};
+
+/// Chunk policy of indirect loops, which checks every chunk of indices for consecutive indices.
+struct ContiguityCheckT
+{
+  /// Optional counter, to which the statistics of a loop are added.
+  contiguity_counter* counter_ = nullptr;
+};
+using NoContiguityCheckT = std::integral_constant<int, 0>;
+constexpr auto ContiguityCheck = ContiguityCheckT();
+constexpr auto NoContiguityCheck = NoContiguityCheckT();
+
+/// Policy of indirect loops, which prefetches the elements accessed by the function a number of chunks ahead.
 /**
- * Linear simd-ized iteration over a function. The function is first called with a simd index and the remainder
- * loop is called with an integral index.
+ * The elements are prefetched from the registered base arrays at the indices read ahead from the index range.
+ * @tparam Level Target cache level (1, 2 or 3).
+ * @tparam ElementTypes Types of the elements of the base arrays.
+ */
+template<int Level, class ... ElementTypes>
+struct PrefetchT
+{
+  static_assert(Level >= 1 && Level <= 3);
+
+  /// Distance of the prefetched chunk to the current chunk in chunks of `SimdSize` indices.
+  size_t distance_;
+  /// Addresses of the first elements of the base arrays.
+  std::tuple<const ElementTypes*...> bases_;
+
+  /// Prefetches the elements of the chunk `distance_` chunks ahead of the chunk at position `i`.
+  /**
+   * @tparam SimdSize Vector size.
+   * @param start Start of the range of indices.
+   * @param i Position of the current chunk in the range of indices.
+   * @param i_end Size of the range of indices.
+   */
+  template<int SimdSize, std::random_access_iterator IteratorType>
+  void prefetch(const IteratorType& start, size_t i, size_t i_end) const
+  {
+    const size_t ahead = i + distance_ * SimdSize;
+    for (size_t k = ahead, k_end = std::min(ahead + SimdSize, i_end); k < k_end; ++k)
+    {
+      const auto index = start[k];
+      std::apply([index](const auto* ... bases) { (__builtin_prefetch(bases + index, 0, 4 - Level), ...); }, bases_);
+    }
+  }
+};
+
+/**
+ * Creates a policy of indirect loops, which prefetches the elements of base arrays a number of chunks ahead. The base
+ * arrays are the arrays accessed by `SIMD_ACCESS` in the function of the loop. The elements at
+ * `&base[0] + index` are prefetched for the indices read ahead from the index range.
+ * @tparam Level Target cache level (1, 2 or 3). Defaults to 1.
+ * @param distance Distance of the prefetched chunk to the current chunk in chunks of `SimdSize` indices.
+ * @param bases Base arrays.
+ * @return The policy.
+ */
+template<int Level = 1>
+inline auto prefetch(size_t distance, const auto& ... bases)
+{
+  return PrefetchT<Level, std::remove_cvref_t<decltype(bases[0])>...>{distance, {&bases[0]...}};
+}
+
+/**
+ * Executes the prefetch policies among the chunk policies of an indirect loop for the chunk at position `i`.
+ * @tparam SimdSize Vector size.
+ * @param start Start of the range of indices.
+ * @param i Position of the current chunk in the range of indices.
+ * @param i_end Size of the range of indices.
+ * @param chunkPolicies Chunk policies of the loop.
+ */
+template<int SimdSize>
+inline void prefetch_chunk(const auto& start, size_t i, size_t i_end, const auto& ... chunkPolicies)
+{
+  ([&](const auto& policy)
+    {
+      if constexpr (requires { policy.template prefetch<SimdSize>(start, i, i_end); })
+      {
+        policy.template prefetch<SimdSize>(start, i, i_end);
+      }
+    }(chunkPolicies), ...);
+}
+
+/**
+ * Adds the statistics of a loop to the counters of the `ContiguityCheck` policies among the chunk policies.
+ * @param contiguous_chunks Number of chunks with consecutive indices.
+ * @param chunks Number of checked chunks.
+ * @param chunkPolicies Chunk policies of the loop.
+ */
+inline void count_contiguous_chunks([[maybe_unused]] size_t contiguous_chunks, [[maybe_unused]] size_t chunks,
+  const auto& ... chunkPolicies)
+{
+  ([&](const auto& policy)
+    {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(policy)>, ContiguityCheckT>)
+      {
+        if (policy.counter_)
+        {
+          policy.counter_->contiguous_chunks_ += contiguous_chunks;
+          policy.counter_->chunks_ += chunks;
+        }
+      }
+    }(chunkPolicies), ...);
+}
+
+/**
+ * Checks, whether the indices of a chunk are consecutive, i.e. `k, k+1, ..., k+SimdSize-1`. The indices are
+ * compared in registers.
+ * @tparam SimdSize Vector size.
+ * @param indices Iterator to the first index of the chunk.
+ * @return True, if the indices are consecutive.
+ */
+template<int SimdSize, std::random_access_iterator IteratorType>
+inline bool is_contiguous_chunk(const IteratorType& indices)
+{
+  using IndexType = std::remove_cvref_t<std::iter_value_t<IteratorType>>;
+  using IndexSimdType = stdx::fixed_size_simd<IndexType, SimdSize>;
+  IndexSimdType values;
+  if constexpr (std::contiguous_iterator<IteratorType>)
+  {
+    values.copy_from(std::to_address(indices), stdx::element_aligned);
+  }
+  else
+  {
+    values = IndexSimdType([&](int i) { return indices[i]; });
+  }
+  return stdx::all_of(values == IndexSimdType([](int i) { return IndexType(i); }) + values[0]);
+}
+
+/**
+ * Calls the function of a loop.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param fn Function to be called.
+ * @param indices Indices passed to the function.
+ */
+template<auto ... Args>
+inline void invoke_loop_body(auto&& fn, const auto& ... indices)
+{
+  if constexpr (sizeof...(Args) == 0)
+  {
+    fn(indices...);
+  }
+  else
+  {
+    fn.template operator()<Args...>(indices...);
+  }
+}
+
+/**
+ * Returns a function for `loop_with_linear_index`, which calls `fn` with the linear index shifted by an offset. It is
+ * used to iterate over a part of an index range, whose linear indices start at `offset`.
+ * @param fn Function called with the shifted linear index and the indirect index.
+ * @param offset Offset added to the linear index.
+ * @return The function.
+ */
+inline auto shift_linear_index(auto& fn, size_t offset)
+{
+  return [&fn, offset]<auto ... Args>(auto i, const auto& simd_i)
+    {
+      if constexpr (std::is_integral_v<decltype(i)>)
+      {
+        i += offset;
+      }
+      else
+      {
+        i.index_ += offset;
+      }
+      invoke_loop_body<Args...>(fn, i, simd_i);
+    };
+}
+
+/// Array, to whose elements the vectorized iterations of a linear loop are aligned.
+struct alignment_reference
+{
+  /// Address of the element at index 0 of the array.
+  const void* base_;
+  /// Size in bytes of the elements of the array.
+  size_t element_size_;
+
+  /// Return the number of iterations from `start` up to the first element aligned to the vector size.
+  /**
+   * @tparam SimdSize Vector size.
+   * @param start Index of the first iteration.
+   * @return The number of iterations to be peeled, 0 if the array can't be aligned.
+   */
+  template<int SimdSize>
+  size_t peel_count(size_t start) const
+  {
+    const size_t alignment = element_size_ * SimdSize;
+    if ((alignment & (alignment - 1)) != 0)
+    {
+      return 0;
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(base_) + start * element_size_;
+    const size_t gap = (alignment - address % alignment) % alignment;
+    return gap % element_size_ == 0 ? gap / element_size_ : 0;
+  }
+
+  /// Return true, if the element at index `i` is aligned to the vector size.
+  /**
+   * @tparam SimdSize Vector size.
+   * @param i Index of the element.
+   * @return True, if the element is aligned, false otherwise or if the array can't be aligned.
+   */
+  template<int SimdSize>
+  bool is_aligned(size_t i) const
+  {
+    const size_t alignment = element_size_ * SimdSize;
+    return (alignment & (alignment - 1)) == 0 &&
+      (reinterpret_cast<std::uintptr_t>(base_) + i * element_size_) % alignment == 0;
+  }
+};
+
+/// Policy of linear loops, which writes consecutive elements by non-temporal (streaming) stores.
+/**
+ * The loop peels iterations at its start until the elements of the destination array are aligned to the vector size,
+ * calls the function with a `streaming_index` and issues a store fence at its end.
+ */
+struct StreamingStoreT : alignment_reference
+{
+};
+
+/**
+ * Creates a policy of linear loops, which writes consecutive elements by non-temporal (streaming) stores. All
+ * consecutive accesses in the function of the loop become streaming accesses (see `value_access::streaming()`).
+ * @param dest Destination array, to which the vectorized iterations are aligned.
+ * @return The policy.
+ */
+inline auto streaming_store(const auto& dest)
+{
+  return StreamingStoreT{{&dest[0], sizeof(dest[0])}};
+}
+
+/// Policy of linear loops, which loads and stores consecutive elements by aligned vector accesses.
+/**
+ * The loop peels iterations at its start until the elements of the reference array are aligned to the vector size
+ * and calls the function with an `aligned_index`. All arrays accessed by this index must have the same alignment
+ * as the reference array, i.e. `&array[i]` must be aligned to the vector size, if `&reference[i]` is aligned.
+ */
+struct AlignedAccessT : alignment_reference
+{
+};
+
+/**
+ * Creates a policy of linear loops, which loads and stores consecutive elements by aligned vector accesses (see
+ * `aligned_index`).
+ * @param reference Reference array, to which the vectorized iterations are aligned.
+ * @return The policy.
+ */
+inline auto aligned_access(const auto& reference)
+{
+  return AlignedAccessT{{&reference[0], sizeof(reference[0])}};
+}
+
+/// Policy of linear loops, which unrolls the vectorized loop by a factor.
+/**
+ * The function is called with a simd index of `Factor * SimdSize` consecutive elements, thus the dependency chains of
+ * `Factor` chunks are interleaved in one call. Remaining chunks are executed with simd indices of `SimdSize`
+ * elements, residual iterations according to the residual loop policy. Since the alignment of aligned and streaming
+ * accesses refers to `SimdSize`, the function is called `Factor` times per iteration with the indices of consecutive
+ * chunks instead, if combined with `aligned_access` or `streaming_store`.
+ * @tparam Factor Unroll factor.
+ */
+template<int Factor>
+struct UnrollT
+{
+  static_assert(Factor > 0);
+};
+template<int Factor>
+constexpr auto Unroll = UnrollT<Factor>();
+
+/// Unroll factor of a chunk policy, which is 1 except for `UnrollT`.
+template<class ChunkPolicyType>
+constexpr int unroll_factor_v = 1;
+template<int Factor>
+constexpr int unroll_factor_v<UnrollT<Factor>> = Factor;
+
+/// Policy of linear loops, which iterates every `Distance`-th index, e.g. a column of a row-major matrix.
+/**
+ * The function is called with a `strided_index<SimdSize, Distance, IntegralType>`, whose accesses use pitched loads
+ * for small distances.
+ * @tparam Distance Distance of the iterated indices.
+ */
+template<size_t Distance>
+struct StrideT
+{
+  static_assert(Distance > 0);
+
+  /// Return the simd index of the chunk starting at `start`.
+  template<int SimdSize, class IndexType>
+  auto simd_index(IndexType start) const { return strided_index<SimdSize, Distance, IndexType>{start}; }
+};
+template<size_t Distance>
+constexpr auto Stride = StrideT<Distance>();
+
+/// Policy of linear loops, which iterates every `stride_`-th index with a distance known at runtime.
+/**
+ * The function is called with a `runtime_strided_index<SimdSize, IntegralType>`, whose accesses use native gather
+ * and scatter instructions.
+ */
+struct RuntimeStrideT
+{
+  /// Distance of the iterated indices, must not be zero.
+  size_t stride_;
+
+  /// Return the simd index of the chunk starting at `start`.
+  template<int SimdSize, class IndexType>
+  auto simd_index(IndexType start) const
+  {
+    return runtime_strided_index<SimdSize, IndexType>{start, IndexType(stride_)};
+  }
+};
+
+/**
+ * Creates a policy of linear loops, which iterates every `distance`-th index (see `RuntimeStrideT`).
+ * @param distance Distance of the iterated indices, must not be zero.
+ * @return The policy.
+ */
+inline auto stride(std::integral auto distance)
+{
+  return RuntimeStrideT{size_t(distance)};
+}
+
+/// Checks, whether a chunk policy of linear loops is `Stride<Distance>` or created by `stride(distance)`.
+template<class ChunkPolicyType>
+concept is_stride_policy = requires(const ChunkPolicyType& policy) { policy.template simd_index<1>(size_t(0)); };
+
+/**
+ * Executes the iterations at the start of a linear loop, which precede the first aligned element of the reference
+ * array of an `aligned_access` or `streaming_store` policy among the chunk policies. Nothing is peeled for
+ * `VectorResidualLoop`, since the function isn't called with integral indices then.
  * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
  * @param start Start of the iteration range [start, end).
  * @param end End of the iteration range [start, end).
- * @param fn Generic function to be called. Takes one argument, whose type is either `index<SimdSize, IntegralType>`
- *   or `IntegralType`.
- * @param residualLoopPolicy Determines the execution policy of residual iterations. If `ScalarResidualLoop`, residual
- *   iterations are executed one by one. If `VectorResidualLoop`, residual iterations are executed vectorized. In that
- *   case the user is responsible for the handling of indices possbily extending the valid iteration range. Defaults
- *   to `ScalarResidualLoop`.
+ * @param fn Function of the loop.
+ * @param residualLoopPolicy Execution policy of the residual iterations, which is applied to the peeled iterations.
+ * @param chunkPolicies Chunk policies of the loop.
+ * @return The start of the remaining iterations.
  */
-template<int SimdSize, auto ... Args, typename ResidualLoopPolicyType = ScalarResidualLoopT>
-inline void loop(std::integral auto start, std::integral auto end, auto&& fn,
-  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+template<int SimdSize, auto ... Args, class IndexType, class ResidualLoopPolicyType>
+inline IndexType peel_loop(IndexType start, IndexType end, auto&& fn, ResidualLoopPolicyType,
+  const auto& ... chunkPolicies)
 {
-  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
-  index<SimdSize, IndexType> simd_i{IndexType(start)};
-  constexpr auto endOffset = residualLoopPolicy == ScalarResidualLoop ? 1 : SimdSize;
+  size_t peel = 0;
+  ([&](const auto& policy)
+    {
+      if constexpr (std::is_base_of_v<alignment_reference, std::remove_cvref_t<decltype(policy)>>)
+      {
+        peel = policy.template peel_count<SimdSize>(size_t(start));
+      }
+    }(chunkPolicies), ...);
+  const IndexType peel_end = start < end ? IndexType(std::min(size_t(end - start), peel) + start) : start;
+  if constexpr (ResidualLoopPolicyType() == ScalarResidualLoop)
+  {
+    for (IndexType i = start; i < peel_end; ++i)
+    {
+      invoke_loop_body<Args...>(fn, i);
+    }
+  }
+  else if constexpr (ResidualLoopPolicyType() == MaskedResidualLoop)
+  {
+    if (start < peel_end)
+    {
+      index<SimdSize, IndexType> simd_i{start};
+      invoke_loop_body<Args...>(fn, masked_index<SimdSize, IndexType>{start, simd_i.to_simd() < peel_end});
+    }
+  }
+  else
+  {
+    return start;
+  }
+  return peel_end;
+}
+
+/**
+ * Returns true, if the reference arrays of all `aligned_access` policies among the chunk policies are aligned to the
+ * vector size at index `i`.
+ * @tparam SimdSize Vector size.
+ * @param i Index of the first vectorized iteration.
+ * @param chunkPolicies Chunk policies of the loop.
+ */
+template<int SimdSize>
+inline bool is_aligned_at(size_t i, const auto& ... chunkPolicies)
+{
+  bool aligned = true;
+  ([&](const auto& policy)
+    {
+      if constexpr (std::is_same_v<std::remove_cvref_t<decltype(policy)>, AlignedAccessT>)
+      {
+        aligned = aligned && policy.template is_aligned<SimdSize>(i);
+      }
+    }(chunkPolicies), ...);
+  return aligned;
+}
+
+/**
+ * Executes the vectorized and the residual iterations of a linear loop, i.e. the iterations following the peeled
+ * ones.
+ * @tparam SimdSize Vector size.
+ * @tparam SimdIndexType Type of the simd index passed to the function.
+ * @tparam UnrollFactor Unroll factor of the vectorized iterations (see `UnrollT`).
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param fn Function of the loop.
+ * @param residualLoopPolicy Execution policy of the residual iterations.
+ */
+template<int SimdSize, class SimdIndexType, int UnrollFactor, auto ... Args, class IndexType,
+  class ResidualLoopPolicyType>
+inline void loop_chunks(IndexType start, IndexType end, auto&& fn, ResidualLoopPolicyType residualLoopPolicy)
+{
+  SimdIndexType simd_i{{start}};
+  if constexpr (UnrollFactor > 1)
+  {
+    for (; simd_i.index_ + UnrollFactor * SimdSize <= end; simd_i.index_ += UnrollFactor * SimdSize)
+    {
+      if constexpr (!std::is_same_v<SimdIndexType, index<SimdSize, IndexType>>)
+      {
+        [&]<int... Chunk>(std::integer_sequence<int, Chunk...>)
+        {
+          (invoke_loop_body<Args...>(fn, SimdIndexType{{IndexType(simd_i.index_ + Chunk * SimdSize)}}), ...);
+        }(std::make_integer_sequence<int, UnrollFactor>());
+      }
+      else
+      {
+        invoke_loop_body<Args...>(fn, index<UnrollFactor * SimdSize, IndexType>{simd_i.index_});
+      }
+    }
+  }
+  constexpr auto endOffset = residualLoopPolicy == VectorResidualLoop ? SimdSize : 1;
   for (; simd_i.index_ + SimdSize < end + endOffset; simd_i.index_ += SimdSize)
   {
     if constexpr (sizeof...(Args) == 0)
@@ -65,6 +497,126 @@ inline void loop(std::integral auto start, std::integral auto end, auto&& fn,
       }
     }
   }
+  else if constexpr (residualLoopPolicy == MaskedResidualLoop)
+  {
+    if (simd_i.index_ < end)
+    {
+      masked_index<SimdSize, IndexType> masked_i{simd_i.index_, simd_i.to_simd() < IndexType(end)};
+      if constexpr (sizeof...(Args) == 0)
+      {
+        fn(masked_i);
+      }
+      else
+      {
+        fn.template operator()<Args...>(masked_i);
+      }
+    }
+  }
+}
+
+/**
+ * Linear simd-ized iteration over a function. The function is first called with a simd index and the remainder
+ * loop is called with an integral index.
+ * @tparam SimdSize Vector size.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param fn Generic function to be called. Takes one argument, whose type is either `index<SimdSize, IntegralType>`,
+ *   `streaming_index<SimdSize, IntegralType>`, `aligned_index<SimdSize, IntegralType>`,
+ *   `masked_index<SimdSize, IntegralType>` or `IntegralType`.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations. If `ScalarResidualLoop`, residual
+ *   iterations are executed one by one. If `VectorResidualLoop`, residual iterations are executed vectorized. In that
+ *   case the user is responsible for the handling of indices possbily extending the valid iteration range. If
+ *   `MaskedResidualLoop`, the residual iterations are executed by one call with a masked index, whose inactive lanes
+ *   are not accessed. Defaults to `ScalarResidualLoop`.
+ * @param chunkPolicies Optional policies applied to the loop. If a policy created by `streaming_store` is given, the
+ *   iterations up to the first aligned element of its destination array are peeled according to
+ *   `residualLoopPolicy`, the function is called with a `streaming_index` instead of an `index` and a store fence is
+ *   issued at the end of the loop. If a policy created by `aligned_access` is given, the iterations up to the first
+ *   aligned element of its reference array are peeled and the function is called with an `aligned_index`. If the
+ *   reference array isn't aligned at the first vectorized iteration (e.g. for `VectorResidualLoop`, which doesn't
+ *   peel), the function is called with an `index` instead. If `Unroll<Factor>` is given, the function is called with
+ *   an `index<Factor * SimdSize, IntegralType>` as long as possible (see `UnrollT`). A policy `Stride<Distance>` or
+ *   `stride(distance)` selects the strided loop below, it can't be combined with other chunk policies.
+ */
+template<int SimdSize, auto ... Args, typename ResidualLoopPolicyType = ScalarResidualLoopT,
+  typename ... ChunkPolicyTypes>
+inline void loop(std::integral auto start, std::integral auto end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, const ChunkPolicyTypes& ... chunkPolicies)
+{
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  constexpr bool is_streaming = (std::is_same_v<ChunkPolicyTypes, StreamingStoreT> || ...);
+  constexpr bool is_aligned = (std::is_same_v<ChunkPolicyTypes, AlignedAccessT> || ...);
+  static_assert(!(is_streaming && is_aligned), "streaming stores are already aligned to their destination array");
+  static_assert(!(is_stride_policy<ChunkPolicyTypes> || ...), "strided loops take no other chunk policies");
+  using SimdIndexType = std::conditional_t<is_streaming, streaming_index<SimdSize, IndexType>,
+    std::conditional_t<is_aligned, aligned_index<SimdSize, IndexType>, index<SimdSize, IndexType>>>;
+  constexpr int unrollFactor = std::max({1, unroll_factor_v<ChunkPolicyTypes>...});
+  const IndexType vector_start = peel_loop<SimdSize, Args...>(IndexType(start), IndexType(end), fn,
+    residualLoopPolicy, chunkPolicies...);
+  if constexpr (is_aligned)
+  {
+    // Without peeling (`VectorResidualLoop` or a reference array, which can't be aligned) the vectorized iterations
+    // may start at a misaligned element.
+    if (!is_aligned_at<SimdSize>(size_t(vector_start), chunkPolicies...))
+    {
+      loop_chunks<SimdSize, index<SimdSize, IndexType>, unrollFactor, Args...>(vector_start, IndexType(end), fn,
+        residualLoopPolicy);
+      return;
+    }
+  }
+  loop_chunks<SimdSize, SimdIndexType, unrollFactor, Args...>(vector_start, IndexType(end), fn, residualLoopPolicy);
+  if constexpr (is_streaming)
+  {
+    native_stream_fence();
+  }
+}
+
+/**
+ * Linear simd-ized iteration over every `Distance`-th index of a range, i.e. over the indices `start`,
+ * `start + Distance`, ... smaller than `end`. The function is called with a strided simd index for every chunk of
+ * `SimdSize` iterations, the residual iterations are executed according to the residual loop policy.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param fn Generic function to be called. Takes one argument, whose type is either
+ *   `strided_index<SimdSize, Distance, IntegralType>` (for `Stride<Distance>`),
+ *   `runtime_strided_index<SimdSize, IntegralType>` (for `stride(distance)`),
+ *   `masked_index_array<SimdSize, stdx::fixed_size_simd<IntegralType, SimdSize>>` (for `MaskedResidualLoop`) or
+ *   `IntegralType`.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ * @param stridePolicy `Stride<Distance>` or the policy created by `stride(distance)`.
+ */
+template<int SimdSize, auto ... Args, typename ResidualLoopPolicyType, is_stride_policy StridePolicyType>
+inline void loop(std::integral auto start, std::integral auto end, auto&& fn, ResidualLoopPolicyType,
+  const StridePolicyType& stridePolicy)
+{
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  auto simd_i = stridePolicy.template simd_index<SimdSize>(IndexType(start));
+  const IndexType distance = simd_i.stride();
+  const IndexType count = IndexType(start) < IndexType(end) ?
+    IndexType((IndexType(end) - IndexType(start) + distance - 1) / distance) : IndexType(0);
+  constexpr IndexType endOffset = ResidualLoopPolicyType() == VectorResidualLoop ? SimdSize : 1;
+  IndexType k = 0;
+  for (; k + SimdSize < count + endOffset; k += SimdSize, simd_i.index_ += IndexType(SimdSize) * distance)
+  {
+    invoke_loop_body<Args...>(fn, simd_i);
+  }
+  if constexpr (ResidualLoopPolicyType() == ScalarResidualLoop)
+  {
+    for (; k < count; ++k, simd_i.index_ += distance)
+    {
+      invoke_loop_body<Args...>(fn, simd_i.index_);
+    }
+  }
+  else if constexpr (ResidualLoopPolicyType() == MaskedResidualLoop)
+  {
+    if (k < count)
+    {
+      auto lanes = stdx::fixed_size_simd<IndexType, SimdSize>([](auto lane) { return IndexType(lane); });
+      invoke_loop_body<Args...>(fn, make_masked_index(simd_i, lanes < IndexType(count - k)));
+    }
+  }
 }
 
 /**
@@ -76,31 +628,44 @@ inline void loop(std::integral auto start, std::integral auto end, auto&& fn,
  * @param start Inclusive start of the range of indices.
  * @param end Exclusive end of the range of indices.
  * @param fn Generic function to be called. Takes one argument, whose type is either
- *   `index_array<SimdSize, IteratorType>` or `IntegralType`.
+ *   `index_array<SimdSize, IteratorType>`, `masked_index_array<SimdSize, IteratorType>` or `IntegralType`.
  * @param residualLoopPolicy Determines the execution policy of residual iterations. If `ScalarResidualLoop`, residual
  *   iterations are executed one by one. If `VectorResidualLoop`, residual iterations are executed vectorized. In that
- *   case the user is responsible for the handling of indices possbily extending the valid iteration range. Defaults
- *   to `ScalarResidualLoop`.
+ *   case the user is responsible for the handling of indices possbily extending the valid iteration range. If
+ *   `MaskedResidualLoop`, the residual iterations are executed by one call with a masked index, whose inactive lanes
+ *   are not accessed. Defaults to `ScalarResidualLoop`.
+ * @param chunkPolicies Optional policies applied to every chunk of indices. If `ContiguityCheck` is given, every chunk
+ *   is checked, whether its indices are consecutive. In that case the function is called with an
+ *   `index<SimdSize, IndexType>` instead of an `index_array`, thus its accesses become vector loads and stores. The
+ *   statistics are added to the counter of the policy, if present. If a policy created by `prefetch` is given, the
+ *   elements of its base arrays are prefetched for the indices of a chunk ahead.
  */
 template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
-  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+  typename ResidualLoopPolicyType = ScalarResidualLoopT, typename ... ChunkPolicyTypes>
 inline void loop(IteratorType start, const IteratorType& end, auto&& fn,
-  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, const ChunkPolicyTypes& ... chunkPolicies)
 {
+  constexpr bool checkContiguity = (std::is_same_v<ChunkPolicyTypes, ContiguityCheckT> || ...);
+  using IndexType = std::remove_cvref_t<std::iter_value_t<IteratorType>>;
   index_array<SimdSize, IteratorType> simd_i{start};
   size_t i = 0, i_end = end - start;
-  constexpr auto endOffset = residualLoopPolicy == ScalarResidualLoop ? 1 : SimdSize;
+  [[maybe_unused]] size_t contiguous_chunks = 0;
+  constexpr auto endOffset = residualLoopPolicy == VectorResidualLoop ? SimdSize : 1;
   for (; i + SimdSize < i_end + endOffset; i += SimdSize, simd_i.index_ += SimdSize)
   {
-    if constexpr (sizeof...(Args) == 0)
+    prefetch_chunk<SimdSize>(start, i, i_end, chunkPolicies...);
+    if constexpr (checkContiguity)
     {
-      fn(simd_i);
-    }
-    else
-    {
-      fn.template operator()<Args...>(simd_i);
+      if (i + SimdSize <= i_end && is_contiguous_chunk<SimdSize>(simd_i.index_))
+      {
+        ++contiguous_chunks;
+        invoke_loop_body<Args...>(fn, index<SimdSize, IndexType>{*simd_i.index_});
+        continue;
+      }
     }
+    invoke_loop_body<Args...>(fn, simd_i);
   }
+  count_contiguous_chunks(contiguous_chunks, i_end / SimdSize, chunkPolicies...);
   if constexpr (residualLoopPolicy == ScalarResidualLoop)
   {
     for (; i < i_end; ++i)
@@ -115,6 +680,22 @@ inline void loop(IteratorType start, const IteratorType& end, auto&& fn,
       }
     }
   }
+  else if constexpr (residualLoopPolicy == MaskedResidualLoop)
+  {
+    if (i < i_end)
+    {
+      auto lanes = stdx::fixed_size_simd<size_t, SimdSize>([](auto lane) { return size_t(lane); });
+      masked_index_array<SimdSize, IteratorType> masked_i{simd_i.index_, lanes < i_end - i};
+      if constexpr (sizeof...(Args) == 0)
+      {
+        fn(masked_i);
+      }
+      else
+      {
+        fn.template operator()<Args...>(masked_i);
+      }
+    }
+  }
 }
 
 /**
@@ -126,33 +707,44 @@ inline void loop(IteratorType start, const IteratorType& end, auto&& fn,
  * @param start Inclusive start of the range of indices.
  * @param end Exclusive end of the range of indices.
  * @param fn Generic function to be called. Takes two arguments. The first is the linear index starting at 0, its
- *   type is either `index<SimdSize, size_t>` or `size_t`. The second argument is the indirect index, its type is
- *   either `index_array<SimdSize, IteratorType>` or `IntegralType`.
+ *   type is either `index<SimdSize, size_t>`, `masked_index<SimdSize, size_t>` or `size_t`. The second argument is
+ *   the indirect index, its type is either `index_array<SimdSize, IteratorType>`,
+ *   `masked_index_array<SimdSize, IteratorType>` or `IntegralType`.
  * @param residualLoopPolicy Determines the execution policy of residual iterations. If `ScalarResidualLoop`, residual
  *   iterations are executed one by one. If `VectorResidualLoop`, residual iterations are executed vectorized. In that
- *   case the user is responsible for the handling of indices possbily extending the valid iteration range. Defaults
- *   to `ScalarResidualLoop`.
+ *   case the user is responsible for the handling of indices possbily extending the valid iteration range. If
+ *   `MaskedResidualLoop`, the residual iterations are executed by one call with a masked index, whose inactive lanes
+ *   are not accessed. Defaults to `ScalarResidualLoop`.
+ * @param chunkPolicies Optional policies applied to every chunk of indices (see `loop`). With `ContiguityCheck` the
+ *   function is called with an `index<SimdSize, IndexType>` as indirect index for chunks of consecutive indices.
  */
 template<int SimdSize, auto ... Args, std::random_access_iterator IteratorType,
-  typename ResidualLoopPolicyType = ScalarResidualLoopT>
+  typename ResidualLoopPolicyType = ScalarResidualLoopT, typename ... ChunkPolicyTypes>
 inline void loop_with_linear_index(IteratorType start, const IteratorType& end, auto&& fn,
-  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, const ChunkPolicyTypes& ... chunkPolicies)
 {
+  constexpr bool checkContiguity = (std::is_same_v<ChunkPolicyTypes, ContiguityCheckT> || ...);
+  using IndexType = std::remove_cvref_t<std::iter_value_t<IteratorType>>;
   index_array<SimdSize, IteratorType> simd_i{start};
   size_t i_end = end - start;
-  constexpr auto endOffset = residualLoopPolicy == ScalarResidualLoop ? 1 : SimdSize;
+  [[maybe_unused]] size_t contiguous_chunks = 0;
+  constexpr auto endOffset = residualLoopPolicy == VectorResidualLoop ? SimdSize : 1;
   index<SimdSize, size_t> i{0};
   for (; i.index_ + SimdSize < i_end + endOffset; i.index_ += SimdSize, simd_i.index_ += SimdSize)
   {
-    if constexpr (sizeof...(Args) == 0)
+    prefetch_chunk<SimdSize>(start, i.index_, i_end, chunkPolicies...);
+    if constexpr (checkContiguity)
     {
-      fn(i, simd_i);
-    }
-    else
-    {
-      fn.template operator()<Args...>(i, simd_i);
+      if (i.index_ + SimdSize <= i_end && is_contiguous_chunk<SimdSize>(simd_i.index_))
+      {
+        ++contiguous_chunks;
+        invoke_loop_body<Args...>(fn, i, index<SimdSize, IndexType>{*simd_i.index_});
+        continue;
+      }
     }
+    invoke_loop_body<Args...>(fn, i, simd_i);
   }
+  count_contiguous_chunks(contiguous_chunks, i_end / SimdSize, chunkPolicies...);
   if constexpr (residualLoopPolicy == ScalarResidualLoop)
   {
     for (; i.index_ < i_end; ++i.index_)
@@ -167,6 +759,308 @@ inline void loop_with_linear_index(IteratorType start, const IteratorType& end,
       }
     }
   }
+  else if constexpr (residualLoopPolicy == MaskedResidualLoop)
+  {
+    if (i.index_ < i_end)
+    {
+      masked_index<SimdSize, size_t> masked_i{i.index_, i.to_simd() < i_end};
+      masked_index_array<SimdSize, IteratorType> masked_simd_i{simd_i.index_, masked_i.mask_};
+      if constexpr (sizeof...(Args) == 0)
+      {
+        fn(masked_i, masked_simd_i);
+      }
+      else
+      {
+        fn.template operator()<Args...>(masked_i, masked_simd_i);
+      }
+    }
+  }
+}
+
+/// Policy of multi-dimensional loops, which iterates the box in tiles.
+/**
+ * The tiles are iterated in row-major order and the points of a tile are iterated in row-major order, thus the data
+ * of a tile is reused from the caches (e.g. by the neighbours of a stencil).
+ * @tparam Rank Number of dimensions.
+ */
+template<size_t Rank>
+struct TilingT
+{
+  /// Number of points of a tile in each dimension, 0 for the whole extent of the box.
+  std::array<size_t, Rank> sizes_;
+};
+
+/**
+ * Creates a policy of multi-dimensional loops, which iterates the box in tiles.
+ * @param sizes Number of points of a tile in each dimension, 0 for the whole extent of the box.
+ * @return The policy.
+ */
+inline auto tiling(std::integral auto ... sizes)
+{
+  return TilingT<sizeof...(sizes)>{{size_t(sizes)...}};
+}
+
+/**
+ * Calls a function for every point of a part of a box, whose coordinates in the dimensions `[Dim, EndDim)` are
+ * iterated in row-major order.
+ * @param position The point, whose coordinates in the dimensions `[Dim, EndDim)` are set.
+ * @param start Start of the iteration range in each dimension.
+ * @param end End of the iteration range in each dimension.
+ * @param fn Function called without arguments.
+ * @param step Optional step in each dimension, defaults to 1.
+ */
+template<size_t Dim, size_t EndDim, class IndexType, size_t Rank, class... StepType>
+inline void for_each_point(std::array<IndexType, Rank>& position, const std::array<IndexType, Rank>& start,
+  const std::array<IndexType, Rank>& end, auto&& fn, const StepType& ... step)
+{
+  if constexpr (Dim == EndDim)
+  {
+    fn();
+  }
+  else
+  {
+    for (IndexType i = start[Dim]; i < end[Dim]; i += (IndexType(1) * ... * step[Dim]))
+    {
+      position[Dim] = i;
+      for_each_point<Dim + 1, EndDim>(position, start, end, fn, step...);
+    }
+  }
+}
+
+/**
+ * Simd-ized iteration over the points of a multi-dimensional box in row-major order. Every row (i.e. the range of
+ * the last dimension) is iterated by the linear `loop`, thus it is vectorized along the contiguous dimension of
+ * row-major arrays and has its own residual iterations.
+ * @tparam SimdSize Vector size.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param start Start of the box in each dimension.
+ * @param end End of the box in each dimension.
+ * @param fn Generic function to be called. Takes one argument of type `index_nd<Rank, InnerIndexType, IndexType>`,
+ *   whose index in the last dimension `InnerIndexType` is one of the index types passed by `loop`. Accesses
+ *   `SIMD_ACCESS(base, i)` access the row `base[i.outer_[0]]...[i.outer_[Rank - 2]]` of a multi-dimensional array
+ *   (e.g. a nested C array or a `row_major_view`).
+ * @param residualLoopPolicy Determines the execution policy of the residual iterations of every row (see `loop`).
+ * @param chunkPolicies Optional policies. If a policy created by `tiling` is given, the box is iterated in tiles.
+ *   `Unroll` is applied to every row.
+ */
+template<int SimdSize, auto ... Args, class IndexType, size_t Rank,
+  typename ResidualLoopPolicyType = ScalarResidualLoopT, typename ... ChunkPolicyTypes>
+inline void loop_nd(const std::array<IndexType, Rank>& start, const std::array<IndexType, Rank>& end, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop, const ChunkPolicyTypes& ... chunkPolicies)
+{
+  static_assert(((std::is_same_v<ChunkPolicyTypes, TilingT<Rank>> ||
+    std::is_same_v<ChunkPolicyTypes, UnrollT<unroll_factor_v<ChunkPolicyTypes>>>) && ...),
+    "only tiling and Unroll are supported by multi-dimensional loops");
+  constexpr int unrollFactor = std::max({1, unroll_factor_v<ChunkPolicyTypes>...});
+  auto loop_rows = [&](const std::array<IndexType, Rank>& rows_start, const std::array<IndexType, Rank>& rows_end)
+    {
+      std::array<IndexType, Rank> position;
+      for_each_point<0, Rank - 1>(position, rows_start, rows_end, [&]()
+        {
+          std::array<IndexType, Rank - 1> outer;
+          std::copy_n(position.begin(), Rank - 1, outer.begin());
+          auto row_fn = [&]<auto ... RowArgs>(const auto& i)
+            {
+              invoke_loop_body<RowArgs...>(fn, index_nd<Rank, std::remove_cvref_t<decltype(i)>, IndexType>{outer, i});
+            };
+          loop<SimdSize, Args...>(rows_start[Rank - 1], rows_end[Rank - 1], row_fn, residualLoopPolicy,
+            Unroll<unrollFactor>);
+        });
+    };
+  if constexpr ((std::is_same_v<ChunkPolicyTypes, TilingT<Rank>> || ...))
+  {
+    std::array<IndexType, Rank> tile;
+    for (size_t dim = 0; dim < Rank; ++dim)
+    {
+      tile[dim] = end[dim] > start[dim] ? end[dim] - start[dim] : IndexType(1);
+    }
+    ([&](const auto& policy)
+      {
+        if constexpr (std::is_same_v<std::remove_cvref_t<decltype(policy)>, TilingT<Rank>>)
+        {
+          for (size_t dim = 0; dim < Rank; ++dim)
+          {
+            tile[dim] = policy.sizes_[dim] == 0 ? tile[dim] : IndexType(policy.sizes_[dim]);
+          }
+        }
+      }(chunkPolicies), ...);
+    std::array<IndexType, Rank> tile_start, tile_end;
+    for_each_point<0, Rank>(tile_start, start, end, [&]()
+      {
+        for (size_t dim = 0; dim < Rank; ++dim)
+        {
+          tile_end[dim] = std::min<IndexType>(tile_start[dim] + tile[dim], end[dim]);
+        }
+        loop_rows(tile_start, tile_end);
+      }, tile);
+  }
+  else
+  {
+    loop_rows(start, end);
+  }
+}
+
+/// Binary operation returning the minimum of two scalars or the lane-wise minimum of two simd values.
+struct minimum
+{
+  auto operator()(const auto& x, const auto& y) const
+  {
+    if constexpr (is_stdx_simd<std::remove_cvref_t<decltype(x)>>)
+    {
+      return stdx::min(x, y);
+    }
+    else
+    {
+      return std::min(x, y);
+    }
+  }
+};
+
+/// Binary operation returning the maximum of two scalars or the lane-wise maximum of two simd values.
+struct maximum
+{
+  auto operator()(const auto& x, const auto& y) const
+  {
+    if constexpr (is_stdx_simd<std::remove_cvref_t<decltype(x)>>)
+    {
+      return stdx::max(x, y);
+    }
+    else
+    {
+      return std::max(x, y);
+    }
+  }
+};
+
+/**
+ * Returns the value of a contribution to a reduction, i.e. simd accesses are converted to simd values.
+ * @param x The result of the loop body.
+ * @return The value of `x`.
+ */
+inline auto reduction_operand(const auto& x)
+{
+  if constexpr (requires { x.to_simd(); })
+  {
+    return x.to_simd();
+  }
+  else
+  {
+    return x;
+  }
+}
+
+/**
+ * Reduces the active lanes of a simd value into a scalar result.
+ * @tparam SimdSize Vector size.
+ * @param result The result, which is `std::nullopt`, as long as no value was reduced.
+ * @param prototype Scalar value, which determines the shape of the lane values (e.g. the size of `std::vector`s).
+ * @param value Simd value or structure-of-simd, whose members are given by `simd_members`.
+ * @param op Binary operation.
+ * @param is_active Predicate returning, whether a lane is reduced.
+ */
+template<int SimdSize, class ResultType>
+inline void reduce_lanes(std::optional<ResultType>& result, const ResultType& prototype, const auto& value, auto&& op,
+  auto&& is_active)
+{
+  for (int lane = 0; lane < SimdSize; ++lane)
+  {
+    if (is_active(lane))
+    {
+      ResultType lane_value = prototype;
+      simd_members(lane_value, value, [&](auto& d, const auto& s) { d = s[lane]; });
+      result = result ? ResultType(op(*result, lane_value)) : lane_value;
+    }
+  }
+}
+
+/**
+ * Reduces the results of a function over a linear range (see `loop_reduce`).
+ * @return The reduced value or `std::nullopt` for an empty range.
+ */
+template<int SimdSize, int AccumulatorCount, class IndexType, class ResultType, typename ResidualLoopPolicyType>
+inline std::optional<ResultType> reduce_range(IndexType start, IndexType end, const ResultType& prototype, auto&& fn,
+  auto&& op, ResidualLoopPolicyType)
+{
+  static_assert(AccumulatorCount > 0);
+  std::optional<ResultType> result;
+  index<SimdSize, IndexType> simd_i{start};
+  constexpr auto endOffset = ResidualLoopPolicyType() == VectorResidualLoop ? SimdSize : 1;
+  auto has_chunks = [&](int count) { return simd_i.index_ + IndexType(count * SimdSize) < end + endOffset; };
+  if (has_chunks(1))
+  {
+    // The accumulators are initialized by the first chunks, thus no neutral element of `op` is required.
+    std::array<decltype(reduction_operand(fn(simd_i))), AccumulatorCount> accumulators;
+    int count = 0;
+    for (; count < AccumulatorCount && has_chunks(1); ++count, simd_i.index_ += SimdSize)
+    {
+      accumulators[count] = reduction_operand(fn(simd_i));
+    }
+    // independent accumulators hide the latency of `op`
+    for (; has_chunks(AccumulatorCount);)
+    {
+      for (int k = 0; k < AccumulatorCount; ++k, simd_i.index_ += SimdSize)
+      {
+        accumulators[k] = op(accumulators[k], reduction_operand(fn(simd_i)));
+      }
+    }
+    for (int k = 0; has_chunks(1); ++k, simd_i.index_ += SimdSize)
+    {
+      accumulators[k] = op(accumulators[k], reduction_operand(fn(simd_i)));
+    }
+    for (int k = 1; k < count; ++k)
+    {
+      accumulators[0] = op(accumulators[0], accumulators[k]);
+    }
+    reduce_lanes<SimdSize>(result, prototype, accumulators[0], op, [](int) { return true; });
+  }
+  if constexpr (ResidualLoopPolicyType() == ScalarResidualLoop)
+  {
+    for (IndexType i = simd_i.index_; i < end; ++i)
+    {
+      ResultType value(reduction_operand(fn(i)));
+      result = result ? ResultType(op(*result, value)) : value;
+    }
+  }
+  else if constexpr (ResidualLoopPolicyType() == MaskedResidualLoop)
+  {
+    if (simd_i.index_ < end)
+    {
+      masked_index<SimdSize, IndexType> masked_i{simd_i.index_, simd_i.to_simd() < end};
+      reduce_lanes<SimdSize>(result, prototype, reduction_operand(fn(masked_i)), op,
+        [&](int lane) { return bool(masked_i.mask_[lane]); });
+    }
+  }
+  return result;
+}
+
+/**
+ * Linear simd-ized reduction of the results of a function. The results of the simd calls are accumulated lane-wise in
+ * `AccumulatorCount` independent simd accumulators, which are reduced horizontally at the end. Thus, `op` must be
+ * associative and commutative. The results of residual iterations are reduced into the scalar result.
+ * @tparam SimdSize Vector size.
+ * @tparam AccumulatorCount Number of independent accumulators, which are updated in turn. More than one accumulator
+ *   hides the latency of `op` (e.g. 4 for floating point additions), but changes the order of the operations.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param init Initial value of the result, which is combined with the results of all iterations.
+ * @param fn Generic function to be called (see `loop`). Returns a simd value or a structure-of-simd (whose members are
+ *   given by `simd_members`) for simd indices and a scalar value for scalar indices. Simd accesses are converted to
+ *   simd values.
+ * @param op Binary operation, which is called with scalar values as well as with simd values, e.g. `std::plus<>()`,
+ *   `minimum()` or `maximum()`.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`). Inactive lanes of a
+ *   masked index don't contribute to the result.
+ * @return The result of `op` applied to `init` and the results of all iterations.
+ */
+template<int SimdSize, int AccumulatorCount = 1, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline auto loop_reduce(std::integral auto start, std::integral auto end, const auto& init, auto&& fn, auto&& op,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+{
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  using ResultType = std::remove_cvref_t<decltype(init)>;
+  auto result = reduce_range<SimdSize, AccumulatorCount>(IndexType(start), IndexType(end), ResultType(init), fn, op,
+    residualLoopPolicy);
+  return result ? ResultType(op(init, *result)) : ResultType(init);
 }
 
 } //namespace simd_access
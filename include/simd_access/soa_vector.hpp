@@ -0,0 +1,480 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief A vector storing its elements in structure-of-arrays layout.
+ *
+ * The scalar members of the elements are determined by the reflection API (`simd_members`). Each of them is stored in
+ * a separate array, thus simd accesses to members become vector loads and stores, while the accesses keep the syntax
+ * of accesses to a `std::vector` of structures.
+ */
+
+#ifndef SIMD_ACCESS_SOA_VECTOR
+#define SIMD_ACCESS_SOA_VECTOR
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/vector.hpp"
+
+namespace simd_access
+{
+
+/**
+ * Location of a (sub-)object of the elements of a `soa_container` accessed by a simd index.
+ * @tparam Container Type of the (possibly const) `soa_container`.
+ * @tparam T Type of the (sub-)object.
+ * @tparam IndexType Type of the simd index.
+ */
+template<class Container, class T, class IndexType>
+struct soa_location
+{
+  using value_type = T;
+  /// The accessed container.
+  Container* container_;
+  /// Offset in bytes of the (sub-)object in the elements of the container.
+  size_t offset_;
+  /// The simd index.
+  IndexType indices_;
+
+  template<auto Member>
+  auto member_access() const
+  {
+    const auto& member = Container::template prototype<T>(offset_).*Member;
+    return soa_location<Container, std::remove_cvref_t<decltype(member)>, IndexType>
+      {container_, Container::offset_of(member), indices_};
+  }
+
+  auto array_access(auto i) const
+  {
+    const auto& element = Container::template prototype<T>(offset_)[i];
+    return soa_location<Container, std::remove_cvref_t<decltype(element)>, IndexType>
+      {container_, Container::offset_of(element), indices_};
+  }
+};
+
+template<class Container, class T, class IndexType>
+inline constexpr int location_simd_size<soa_location<Container, T, IndexType>> = IndexType::size();
+
+/**
+ * Restricts a location in a `soa_container` to the active lanes of a simd mask.
+ * @param location The unrestricted location.
+ * @param mask Simd mask.
+ * @return The location with a masked simd index.
+ */
+template<class Container, class T, class IndexType, class MaskType>
+inline auto make_masked_location(const soa_location<Container, T, IndexType>& location, const MaskType& mask)
+{
+  auto indices = make_masked_index(location.indices_, mask);
+  return soa_location<Container, T, decltype(indices)>{location.container_, location.offset_, indices};
+}
+
+/**
+ * Loads a structure-of-simd value from a (sub-)object of the elements of a `soa_container`. Every scalar member is
+ * loaded by a separate simd access of the container, e.g. from its own array.
+ * @tparam ElementSize Unused, the size of the array elements is given by the scalar members.
+ * @param location The location in the container.
+ * @return A structure-of-simd value.
+ */
+template<size_t ElementSize, class Container, class T, class IndexType>
+inline auto load(const soa_location<Container, T, IndexType>& location)
+{
+  const auto& prototype = Container::template prototype<T>(location.offset_);
+  auto result = simdized_value<IndexType::size()>(prototype);
+  simd_members(result, prototype, [&](auto& dest, const auto& member)
+    {
+      dest = location.container_->member_access(member, location.indices_).to_simd();
+    });
+  return result;
+}
+
+/**
+ * Stores a structure-of-simd value to a (sub-)object of the elements of a `soa_container`. Every scalar member is
+ * stored by a separate simd access of the container, e.g. to its own array.
+ * @tparam ElementSize Unused, the size of the array elements is given by the scalar members.
+ * @param location The location in the container.
+ * @param expr The expression, whose result is stored. Must be convertible to a structure-of-simd.
+ */
+template<size_t ElementSize, class Container, class T, class IndexType>
+inline void store(const soa_location<Container, T, IndexType>& location, const auto& expr)
+{
+  const auto& prototype = Container::template prototype<T>(location.offset_);
+  decltype(simdized_value<IndexType::size()>(prototype)) source = expr;
+  simd_members(source, prototype, [&](auto& src, const auto& member)
+    {
+      location.container_->member_access(member, location.indices_) = src;
+    });
+}
+
+/// Reference to a (sub-)object of an element of a `soa_container`, which is returned by scalar accesses.
+/**
+ * @tparam Container Type of the (possibly const) `soa_container`.
+ * @tparam T Type of the (sub-)object.
+ */
+template<class Container, class T>
+class soa_reference
+{
+public:
+  /// Constructor.
+  /**
+   * @param container The accessed container.
+   * @param i Index of the element.
+   * @param offset Offset in bytes of the (sub-)object in the elements of the container.
+   */
+  soa_reference(Container* container, size_t i, size_t offset) :
+    container_(container),
+    i_(i),
+    offset_(offset)
+  {}
+
+  /// Return the value of the referenced object gathered from the arrays of its members.
+  operator T() const
+  {
+    const auto& prototype = Container::template prototype<T>(offset_);
+    T result = prototype;
+    simd_members(result, prototype, [&](auto& dest, const auto& member)
+      {
+        dest = container_->scalar_member(member, i_);
+      });
+    return result;
+  }
+
+  /// Return the value of the referenced object (used by `SIMD_ACCESS_V`).
+  T to_simd() const
+  {
+    return *this;
+  }
+
+  /// Assign a value to the referenced object, whose members are scattered to their arrays.
+  const soa_reference& operator=(const T& value) const
+  {
+    const auto& prototype = Container::template prototype<T>(offset_);
+    T source = value;
+    simd_members(source, prototype, [&](auto& src, const auto& member)
+      {
+        container_->scalar_member(member, i_) = src;
+      });
+    return *this;
+  }
+
+  /// Assign the value of another referenced object.
+  const soa_reference& operator=(const soa_reference& other) const
+  {
+    return *this = T(other);
+  }
+
+private:
+  Container* container_;
+  size_t i_;
+  size_t offset_;
+};
+
+/// Base class of containers, which store the scalar members of their elements separately (e.g. `soa_vector`).
+/**
+ * The base class implements the accesses used by `SIMD_ACCESS` on top of the following member functions of `Derived`
+ * for a scalar member `member` of the prototype:
+ * - `scalar_member(member, i)` returns a reference to the member of the element `i`.
+ * - `member_access(member, indices)` returns a `value_access` to the member of the elements given by a simd index.
+ * @tparam Derived The derived container.
+ * @tparam T Element type, must be trivially copyable and default constructible. Its scalar members are given by
+ *   `simd_members` and must be located inside the object (i.e. no members of type `std::vector`).
+ */
+template<class Derived, class T>
+class soa_container
+{
+  static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>);
+
+public:
+  using value_type = T;
+  static constexpr bool has_custom_layout = true;
+
+  /// Return a reference to an element, i.e. a `soa_reference` for structures.
+  decltype(auto) operator[](size_t i)
+  {
+    return scalar_subobject(i, [](auto& e) -> auto& { return e; });
+  }
+
+  /// Return a constant reference to an element, i.e. a `soa_reference` for structures.
+  decltype(auto) operator[](size_t i) const
+  {
+    return scalar_subobject(i, [](auto& e) -> auto& { return e; });
+  }
+
+  /// Simd access to elements.
+  auto operator[](const is_index auto& index)
+  {
+    return LValueSeparator<true>::to_simd(derived(), index);
+  }
+
+  /// Constant simd access to elements.
+  auto operator[](const is_index auto& index) const
+  {
+    return LValueSeparator<true>::to_simd(derived(), index);
+  }
+
+  /// Scalar access to a subobject of an element (used by `SIMD_ACCESS`).
+  /**
+   * @param i Index of the element.
+   * @param subobject Functor returning the accessed subobject of a given element.
+   * @return A reference to the scalar member or a `soa_reference` for structures.
+   */
+  decltype(auto) scalar_subobject(size_t i, auto&& subobject)
+  {
+    return scalar_subobject_of(&derived(), i, subobject);
+  }
+
+  decltype(auto) scalar_subobject(size_t i, auto&& subobject) const
+  {
+    return scalar_subobject_of(&derived(), i, subobject);
+  }
+
+  /// Simd access to a subobject of the elements (used by `SIMD_ACCESS`).
+  /**
+   * @param indices Simd index.
+   * @param subobject Optional functor returning the accessed subobject of a given element.
+   * @return A `value_access` representing the simd access.
+   */
+  auto simd_subobject(const auto& indices, auto&& ... subobject)
+  {
+    return simd_subobject_of(&derived(), indices, subobject...);
+  }
+
+  auto simd_subobject(const auto& indices, auto&& ... subobject) const
+  {
+    return simd_subobject_of(&derived(), indices, subobject...);
+  }
+
+  /// Return the object, whose subobjects determine the offsets of the members (for the locations in this container).
+  static T& prototype()
+  {
+    return prototype_;
+  }
+
+  /// Return the subobject of the prototype at an offset.
+  template<class SubobjectType>
+  static SubobjectType& prototype(size_t offset)
+  {
+    return *reinterpret_cast<SubobjectType*>(reinterpret_cast<std::byte*>(&prototype()) + offset);
+  }
+
+  /// Return the offset in bytes of a subobject of the prototype.
+  static size_t offset_of(const auto& subobject)
+  {
+    return size_t(reinterpret_cast<const std::byte*>(&subobject) - reinterpret_cast<const std::byte*>(&prototype()));
+  }
+
+  /// Return the number of a scalar member of the prototype in the order of `simd_members`.
+  int member_number(const auto& member) const
+  {
+    return layout_->member_of_offset_[offset_of(member)];
+  }
+
+  /// Return the sizes of the scalar members in the order of `simd_members`.
+  static const std::vector<size_t>& member_sizes()
+  {
+    return layout().member_sizes_;
+  }
+
+private:
+  /// Offsets and sizes of the scalar members of `T`.
+  struct layout_type
+  {
+    /// Sizes of the scalar members in the order of `simd_members`.
+    std::vector<size_t> member_sizes_;
+    /// Number of the scalar member at an offset or -1.
+    std::array<int, sizeof(T)> member_of_offset_;
+
+    layout_type()
+    {
+      member_of_offset_.fill(-1);
+      simd_members(prototype_, prototype_, [&](auto& member, const auto&)
+        {
+          auto offset = reinterpret_cast<const std::byte*>(&member) - reinterpret_cast<const std::byte*>(&prototype_);
+          member_of_offset_[offset] = int(member_sizes_.size());
+          member_sizes_.push_back(sizeof(member));
+        });
+    }
+  };
+
+  static const layout_type& layout()
+  {
+    static const layout_type result;
+    return result;
+  }
+
+  /// Constant initialized, thus accesses to its subobjects are resolved at compile time.
+  static inline T prototype_{};
+  /// The layout is referenced by every container, so that accesses don't check the initialization of the static.
+  const layout_type* layout_ = &layout();
+
+  Derived& derived() { return static_cast<Derived&>(*this); }
+  const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
+  template<class Self>
+  static decltype(auto) scalar_subobject_of(Self* self, size_t i, auto&& subobject)
+  {
+    auto& member = subobject(prototype());
+    using member_type = std::remove_cvref_t<decltype(member)>;
+    if constexpr (simd_arithmetic<member_type>)
+    {
+      return self->scalar_member(member, i);
+    }
+    else
+    {
+      return soa_reference<Self, member_type>(self, i, offset_of(member));
+    }
+  }
+
+  template<class Self, class IndexType, class ... Func>
+  static auto simd_subobject_of(Self* self, const IndexType& indices, Func&& ... subobject)
+  {
+    auto& member = [&]() -> auto&
+      {
+        if constexpr (sizeof...(Func) == 0)
+        {
+          return prototype();
+        }
+        else
+        {
+          return (subobject(prototype()), ...);
+        }
+      }();
+    using member_type = std::remove_cvref_t<decltype(member)>;
+    if constexpr (simd_arithmetic<member_type>)
+    {
+      return self->member_access(member, indices);
+    }
+    else
+    {
+      return make_value_access<sizeof(member_type)>(
+        soa_location<Self, member_type, IndexType>{self, offset_of(member), indices});
+    }
+  }
+};
+
+/// Vector, which stores every scalar member of its elements in a separate array (structure-of-arrays layout).
+/**
+ * Simd accesses via `SIMD_ACCESS(v, i, .member)` load and store the member from its own array, thus they become
+ * vector loads and stores for linear indices instead of pitched accesses. Accesses to (sub-)structures load and store
+ * every scalar member separately. Scalar accesses to scalar members return references to the arrays, scalar accesses
+ * to structures return a `soa_reference`. The member arrays are aligned and padded like `aligned_vector`.
+ * @tparam T Element type (see `soa_container`).
+ */
+template<class T>
+class soa_vector :
+  public soa_container<soa_vector<T>, T>
+{
+  using base = soa_container<soa_vector<T>, T>;
+
+public:
+  /// Constructor creating an empty vector.
+  soa_vector() :
+    arrays_(base::member_sizes().size())
+  {}
+
+  /// Constructor.
+  /**
+   * @param size Number of elements.
+   * @param value Value of the elements.
+   */
+  explicit soa_vector(size_t size, const T& value = T()) :
+    soa_vector()
+  {
+    resize(size, value);
+  }
+
+  /// Return the number of elements.
+  size_t size() const { return size_; }
+
+  /// Return, whether the vector has no elements.
+  bool empty() const { return size_ == 0; }
+
+  /// Change the number of elements.
+  /**
+   * @param size New number of elements.
+   * @param value Value of the added elements.
+   */
+  void resize(size_t size, const T& value = T())
+  {
+    for (size_t k = 0; k < arrays_.size(); ++k)
+    {
+      arrays_[k].resize(size * base::member_sizes()[k]);
+    }
+    for (size_t i = std::exchange(size_, size); i < size; ++i)
+    {
+      (*this)[i] = value;
+    }
+  }
+
+  /// Append an element.
+  void push_back(const T& value)
+  {
+    resize(size_ + 1, value);
+  }
+
+  /// Remove all elements.
+  void clear()
+  {
+    resize(0);
+  }
+
+  /// Return the array of a scalar member.
+  /**
+   * @param member The member of the prototype.
+   * @return Pointer to the array storing this member of all elements.
+   */
+  template<class MemberType>
+  MemberType* member_data(const MemberType& member)
+  {
+    return reinterpret_cast<MemberType*>(arrays_[base::member_number(member)].data());
+  }
+
+  template<class MemberType>
+  const MemberType* member_data(const MemberType& member) const
+  {
+    return reinterpret_cast<const MemberType*>(arrays_[base::member_number(member)].data());
+  }
+
+  /// Return a reference to a scalar member of an element.
+  /**
+   * @param member The member of the prototype.
+   * @param i Index of the element.
+   */
+  auto& scalar_member(const auto& member, size_t i)
+  {
+    return member_data(member)[i];
+  }
+
+  auto& scalar_member(const auto& member, size_t i) const
+  {
+    return member_data(member)[i];
+  }
+
+  /// Return the simd access to the array of a scalar member.
+  /**
+   * @param member The member of the prototype.
+   * @param indices Simd index.
+   * @return A `value_access` to the array of the member.
+   */
+  auto member_access(const auto& member, const auto& indices)
+  {
+    return LValueSeparator<true>::to_simd(member_data(member), indices);
+  }
+
+  auto member_access(const auto& member, const auto& indices) const
+  {
+    return LValueSeparator<true>::to_simd(member_data(member), indices);
+  }
+
+private:
+  size_t size_ = 0;
+  std::vector<std::vector<std::byte, aligned_allocator<std::byte>>> arrays_;
+};
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_SOA_VECTOR
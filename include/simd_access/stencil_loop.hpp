@@ -0,0 +1,115 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Linear loop over a one-dimensional stencil, which reuses the loaded vectors for the neighbours.
+ *
+ * A stencil of radius `R` reads the elements `i - R, ..., i + R` of a source array for every iteration `i`. Accessed
+ * by `SIMD_ACCESS(source, i + k)`, every element is loaded `2 * R + 1` times by unaligned vector loads. The stencil
+ * loop loads every vector of the source array once and synthesizes the neighbour vectors by lane shifts of two
+ * consecutive vectors.
+ */
+
+#ifndef SIMD_ACCESS_STENCIL_LOOP
+#define SIMD_ACCESS_STENCIL_LOOP
+
+#include <array>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+#include "simd_access/intrinsics.hpp"
+#include "simd_access/simd_access.hpp"
+#include "simd_access/simd_loop.hpp"
+
+namespace simd_access
+{
+
+/// The values of the neighbours of an iteration of a stencil loop.
+/**
+ * @tparam Radius Radius of the stencil.
+ * @tparam ValueType Type of the values, a simd type for simd iterations and a scalar type for scalar iterations.
+ */
+template<int Radius, class ValueType>
+struct stencil_window
+{
+  /// The values at the offsets `-Radius, ..., Radius`.
+  std::array<ValueType, 2 * Radius + 1> values_;
+
+  /// Return the value at an offset to the iteration, i.e. `SIMD_ACCESS_V(source, i + offset)`.
+  /**
+   * @param offset Offset in the range [-Radius, Radius].
+   * @return The value.
+   */
+  const ValueType& operator[](int offset) const { return values_[offset + Radius]; }
+};
+
+/**
+ * Loads the neighbours of an iteration of a stencil loop by separate accesses.
+ * @tparam Radius Radius of the stencil.
+ * @param source The array.
+ * @param i Index of the iteration, a linear simd index or an integral index.
+ * @return The `stencil_window` of the iteration.
+ */
+template<int Radius>
+inline auto load_stencil_window(const auto& source, const auto& i)
+{
+  return [&]<int... Offset>(std::integer_sequence<int, Offset...>)
+    {
+      using value_type = decltype(SIMD_ACCESS_V(source, i));
+      return stencil_window<Radius, value_type>{{ SIMD_ACCESS_V(source, i + (Offset - Radius))... }};
+    } (std::make_integer_sequence<int, 2 * Radius + 1>());
+}
+
+/**
+ * Linear simd-ized iteration over a function, which reads the neighbours `i - Radius, ..., i + Radius` of every
+ * iteration `i` from a source array. The vectors of the source array are loaded once and the neighbour vectors are
+ * synthesized by lane shifts, if the elements are of arithmetic type and `2 * Radius <= SimdSize`. The last full
+ * chunks, whose shifted vectors would extend beyond `end + Radius`, and the residual iterations load the neighbours
+ * by separate accesses. No element outside of `[start - Radius, end + Radius)` is read.
+ * @tparam SimdSize Vector size.
+ * @tparam Radius Radius of the stencil.
+ * @tparam Args Optional additional template arguments passed to the function call operator.
+ * @param start Start of the iteration range [start, end).
+ * @param end End of the iteration range [start, end).
+ * @param source The array, whose neighbours are read. It must not be written by the function.
+ * @param fn Generic function to be called. Takes two arguments, the index of the iteration (see `loop`) and the
+ *   `stencil_window` of the iteration, whose `operator[](k)` returns the value of the neighbour `i + k`.
+ * @param residualLoopPolicy Determines the execution policy of residual iterations (see `loop`).
+ */
+template<int SimdSize, int Radius, auto ... Args, typename ResidualLoopPolicyType = ScalarResidualLoopT>
+inline void stencil_loop(std::integral auto start, std::integral auto end, const auto& source, auto&& fn,
+  ResidualLoopPolicyType residualLoopPolicy = ScalarResidualLoop)
+{
+  static_assert(Radius >= 0);
+  using IndexType = std::common_type_t<decltype(start), decltype(end)>;
+  index<SimdSize, IndexType> simd_i{IndexType(start)};
+  using value_type = decltype(SIMD_ACCESS_V(source, simd_i));
+  if constexpr (Radius > 0 && 2 * Radius <= SimdSize && is_stdx_simd<value_type>)
+  {
+    // the upper vector ends at `index_ + 2 * SimdSize - Radius`
+    auto has_upper = [&] { return simd_i.index_ + IndexType(2 * SimdSize) <= IndexType(end) + IndexType(2 * Radius); };
+    if (has_upper())
+    {
+      value_type lower = SIMD_ACCESS_V(source, simd_i - Radius);
+      for (; has_upper(); simd_i.index_ += SimdSize)
+      {
+        value_type upper = SIMD_ACCESS_V(source, simd_i + (SimdSize - Radius));
+        auto window = [&]<int... Shift>(std::integer_sequence<int, Shift...>)
+          {
+            return stencil_window<Radius, value_type>{{ native_align<Shift>(lower, upper)... }};
+          } (std::make_integer_sequence<int, 2 * Radius + 1>());
+        invoke_loop_body<Args...>(fn, simd_i, window);
+        lower = upper;
+      }
+    }
+  }
+  loop<SimdSize, Args...>(simd_i.index_, IndexType(end), [&]<auto ... LoopArgs>(const auto& i)
+    {
+      invoke_loop_body<LoopArgs...>(fn, i, load_stencil_window<Radius>(source, i));
+    }, residualLoopPolicy);
+}
+
+} //namespace simd_access
+
+#endif //SIMD_ACCESS_STENCIL_LOOP
@@ -8,8 +8,11 @@
 #ifndef SIMD_ACCESS_VALUE_ACCESS
 #define SIMD_ACCESS_VALUE_ACCESS
 
+#include <utility>
+
 #include "simd_access/operator_overload.hpp"
 #include "simd_access/load_store.hpp"
+#include "simd_access/reflection.hpp"
 
 namespace simd_access
 {
@@ -17,12 +20,17 @@ namespace simd_access
 #define VALUE_ACCESS_BIN_OP( op ) \
   auto operator op(const auto& source) { return to_simd() op source; }
 
-#define VALUE_ACCESS_BIN_ASSIGNMENT_OP( op ) \
-  void operator op##=(const auto& source) && { store<ElementSize>(location_, to_simd() op source); }
+// combine_op combines two right hand sides of the same element, e.g. `x -= a; x -= b;` equals `x -= a + b;`
+#define VALUE_ACCESS_BIN_ASSIGNMENT_OP( op, combine_op ) \
+  void operator op##=(const auto& source) && \
+  { \
+    store_compound<ElementSize>(location_, simd_operand(source), [](const auto& x, const auto& y) { return x op y; }, \
+      [](const auto& x, const auto& y) { return x combine_op y; }); \
+  }
 
-#define VALUE_ACCESS_MEMBER_OPS( op ) \
+#define VALUE_ACCESS_MEMBER_OPS( op, combine_op ) \
   VALUE_ACCESS_BIN_OP( op ) \
-  VALUE_ACCESS_BIN_ASSIGNMENT_OP( op )
+  VALUE_ACCESS_BIN_ASSIGNMENT_OP( op, combine_op )
 
 #define VALUE_ACCESS_SCALAR_BIN_OP( op ) \
   template<class Location, size_t ElementSize> \
@@ -31,6 +39,27 @@ namespace simd_access
     return o1 op o2.to_simd(); \
   }
 
+/**
+ * Returns the simd value of the right hand side of a compound assignment.
+ * @param x A simd access.
+ * @return The simd value loaded from the memory location of `x`.
+ */
+template<class Location, size_t ElementSize>
+inline auto simd_operand(const value_access<Location, ElementSize>& x)
+{
+  return x.to_simd();
+}
+
+/**
+ * Returns the right hand side of a compound assignment, if it is no simd access.
+ * @param x A simd or scalar value.
+ * @return `x`.
+ */
+inline const auto& simd_operand(const auto& x)
+{
+  return x;
+}
+
 /// Class representing a simd-access (read or write) to a memory location.
 /**
  * @tparam Location Type of the location of the simd data.
@@ -53,10 +82,10 @@ public:
     store<ElementSize>(location_, source);
   }
 
-  VALUE_ACCESS_MEMBER_OPS(+)
-  VALUE_ACCESS_MEMBER_OPS(-)
-  VALUE_ACCESS_MEMBER_OPS(*)
-  VALUE_ACCESS_MEMBER_OPS(/)
+  VALUE_ACCESS_MEMBER_OPS(+, +)
+  VALUE_ACCESS_MEMBER_OPS(-, +)
+  VALUE_ACCESS_MEMBER_OPS(*, *)
+  VALUE_ACCESS_MEMBER_OPS(/, *)
 
   /// Transforms this to a simd value.
   /**
@@ -67,6 +96,44 @@ public:
     return load<ElementSize>(location_);
   }
 
+  /// Restricts this to the active lanes of a simd mask.
+  /**
+   * @param mask Simd mask.
+   * @return A `value_access` representing a simd access to the active lanes of `mask`.
+   */
+  auto masked(const auto& mask) const
+  {
+    return make_value_access<ElementSize>(make_masked_location(location_, mask));
+  }
+
+  /// Selects non-temporal (streaming) stores for this.
+  /**
+   * Assignments to the returned access bypass the cache, if the elements are consecutive, of arithmetic type and
+   * aligned to the vector size. Streaming pays off for large outputs, which aren't read again soon. A
+   * `native_stream_fence()` is required after the last streaming store, before another thread reads the data.
+   * @return A `value_access` representing a simd access, which is written by streaming stores.
+   */
+  auto streaming() const
+  {
+    return make_value_access<ElementSize>(streaming_location<Location>{location_});
+  }
+
+  /// Selects a compute type for this, which differs from the stored type.
+  /**
+   * Loads from the returned access widen the stored elements to `ComputeType`, stores narrow the values to the
+   * stored type with rounding to nearest even. E.g. `float` elements are computed as `double` values. Structures
+   * are converted member by member. See also the free function `as`.
+   * @tparam ComputeType Arithmetic type or structure type, in which the elements are computed.
+   * @tparam Encoding Conversion between the stored type and `ComputeType` (e.g. `float16_encoding`).
+   * @param encoding The conversion, if it has parameters (e.g. a `linear_quantization`).
+   * @return A `value_access` representing a simd access to the elements converted to `ComputeType`.
+   */
+  template<class ComputeType, class Encoding = cast_encoding>
+  auto as(const Encoding& encoding = Encoding()) const
+  {
+    return make_value_access<ElementSize>(converting_location<Location, ComputeType, Encoding>{location_, encoding});
+  }
+
   /// Implementation of overloaded member operator, i.e. operator.()
   /**
    * Since `T` might be of non-class type, one cannot specify `auto T::*Member` as a template argument here.
@@ -104,6 +171,44 @@ inline auto make_value_access(const Location& location)
   return value_access<Location, ElementSize>(location);
 }
 
+// Forward declaration
+template<class M, class T>
+struct where_expression;
+
+/**
+ * Returns a `where_expression` for a simd access to memory. Assignments to the `where_expression` only write the
+ * active lanes of `mask` to memory.
+ * @param mask The value of the simd mask.
+ * @param dest The simd access, to which `mask` is applied.
+ */
+template<class M, class Location, size_t ElementSize>
+inline auto where(const M& mask, const value_access<Location, ElementSize>& dest)
+{
+  return where_expression<M, value_access<Location, ElementSize>>{dest.masked(mask)};
+}
+
+#define WHERE_EXPRESSION_ASSIGNMENT_OP( op ) \
+  void operator op(const auto& source) && { std::move(destination_) op source; }
+
+/**
+ * Extends `stdx::where_expression` for simd accesses to memory.
+ * @tparam M Type of the simd mask.
+ * @tparam Location Type of the location of the simd data.
+ * @tparam ElementSize Size of the array elements.
+ */
+template<class M, class Location, size_t ElementSize>
+struct where_expression<M, value_access<Location, ElementSize>>
+{
+  /// The simd access restricted to the active lanes of the mask.
+  decltype(std::declval<value_access<Location, ElementSize>>().masked(std::declval<M>())) destination_;
+
+  WHERE_EXPRESSION_ASSIGNMENT_OP(=)
+  WHERE_EXPRESSION_ASSIGNMENT_OP(+=)
+  WHERE_EXPRESSION_ASSIGNMENT_OP(-=)
+  WHERE_EXPRESSION_ASSIGNMENT_OP(*=)
+  WHERE_EXPRESSION_ASSIGNMENT_OP(/=)
+};
+
 VALUE_ACCESS_SCALAR_BIN_OP(+)
 VALUE_ACCESS_SCALAR_BIN_OP(-)
 VALUE_ACCESS_SCALAR_BIN_OP(*)
@@ -113,6 +218,96 @@ template<class PotentialSimdType>
 concept has_to_simd =
   requires(PotentialSimdType x) { x.to_simd(); };
 
+#define CONVERTING_REFERENCE_ASSIGNMENT_OP( op ) \
+  void operator op##=(const ComputeType& source) && { std::move(*this) = to_simd() op source; }
+
+/// Reference to a scalar element, which is stored in a compact type and computed in `ComputeType`.
+/**
+ * This is the scalar counterpart of a `value_access` returned by `as`, e.g. in scalar residual iterations.
+ * @tparam T Stored type of the element.
+ * @tparam ComputeType Arithmetic type or structure type, in which the element is computed.
+ * @tparam Encoding Conversion between `T` and `ComputeType`.
+ */
+template<class T, class ComputeType, class Encoding>
+struct converting_reference
+{
+  /// The stored element.
+  T& element_;
+  /// The conversion.
+  [[no_unique_address]] Encoding encoding_;
+
+  /// Return the element converted to `ComputeType`.
+  ComputeType to_simd() const
+  {
+    ComputeType result{};
+    if constexpr (simd_arithmetic<ComputeType>)
+    {
+      encoding_.decode(result, element_);
+    }
+    else
+    {
+      simd_members(result, element_, [&](auto&& dest, auto&& src) { encoding_.decode(dest, src); });
+    }
+    return result;
+  }
+
+  /// Return the element converted to `ComputeType`.
+  operator ComputeType() const
+  {
+    return to_simd();
+  }
+
+  /// Assignment operator, which converts `source` to the stored type.
+  void operator=(const ComputeType& source) &&
+  {
+    if constexpr (simd_arithmetic<ComputeType>)
+    {
+      encoding_.encode(element_, source);
+    }
+    else
+    {
+      simd_members(element_, source, [&](auto&& dest, auto&& src) { encoding_.encode(dest, src); });
+    }
+  }
+
+  CONVERTING_REFERENCE_ASSIGNMENT_OP(+)
+  CONVERTING_REFERENCE_ASSIGNMENT_OP(-)
+  CONVERTING_REFERENCE_ASSIGNMENT_OP(*)
+  CONVERTING_REFERENCE_ASSIGNMENT_OP(/)
+};
+
+/**
+ * Selects a compute type for a simd access, which differs from the stored type (see `value_access::as`). Unlike the
+ * member function, this function can be called on dependent simd accesses without the `template` keyword, e.g.
+ * `as<double>(SIMD_ACCESS(v, i, .x)) += dt * SIMD_ACCESS_V(v, i, .y)` in a generic loop body.
+ * @tparam ComputeType Arithmetic type or structure type, in which the elements are computed.
+ * @tparam Encoding Conversion between the stored type and `ComputeType` (e.g. `float16_encoding`).
+ * @param x The simd access.
+ * @param encoding The conversion, if it has parameters (e.g. a `linear_quantization`).
+ * @return A `value_access` representing a simd access to the elements converted to `ComputeType`.
+ */
+template<class ComputeType, class Encoding = cast_encoding, class Location, size_t ElementSize>
+inline auto as(const value_access<Location, ElementSize>& x, const Encoding& encoding = Encoding())
+{
+  return x.template as<ComputeType, Encoding>(encoding);
+}
+
+/**
+ * Selects a compute type for a scalar element, which differs from the stored type, e.g. the result of `SIMD_ACCESS`
+ * with a scalar index.
+ * @tparam ComputeType Arithmetic type or structure type, in which the element is computed.
+ * @tparam Encoding Conversion between the stored type and `ComputeType`.
+ * @param x The stored element.
+ * @param encoding The conversion, if it has parameters.
+ * @return A `converting_reference` to the element.
+ */
+template<class ComputeType, class Encoding = cast_encoding, class T>
+  requires(!has_to_simd<T>)
+inline auto as(T& x, const Encoding& encoding = Encoding())
+{
+  return converting_reference<T, ComputeType, Encoding>{x, encoding};
+}
+
 } //namespace simd_access
 
 #endif //SIMD_ACCESS_VALUE_ACCESS
@@ -2,12 +2,15 @@
 
 /**
  * @file
- * @brief An extended std::vector.
+ * @brief An extended std::vector and an aligned and padded variant of it.
  */
 
 #ifndef SIMD_ACCESS_VECTOR
 #define SIMD_ACCESS_VECTOR
 
+#include <cstddef>
+#include <new>
+#include <type_traits>
 #include <vector>
 
 #include "simd_access/base.hpp"
@@ -38,6 +41,64 @@ struct SimdIndexOperator : Base
 template<typename... Args>
 using vector = SimdIndexOperator<std::vector<Args...>>;
 
+/// Allocator, whose allocations are aligned and padded to a multiple of `Alignment` bytes.
+/**
+ * The padding allows vectorized accesses to the lanes after the last element, as long as the vectorized iterations
+ * start at a multiple of the vector size, which divides `Alignment / sizeof(T)` (see `VectorResidualLoop`). The padding
+ * is raw storage, which isn't initialized and isn't part of the capacity of a container. Vector loads reading it are
+ * only valid for trivially copyable elements, thus other element types are rejected.
+ * @tparam T Type of the allocated elements, must be trivially copyable.
+ * @tparam Alignment Alignment in bytes. Defaults to the size of a cache line, which is also the size of the largest
+ *   vector registers.
+ */
+template<class T, size_t Alignment = 64>
+struct aligned_allocator
+{
+  static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+  static_assert(std::is_trivially_copyable_v<T>, "the padding is only accessible for trivially copyable elements");
+
+  using value_type = T;
+
+  template<class U>
+  struct rebind
+  {
+    using other = aligned_allocator<U, Alignment>;
+  };
+
+  aligned_allocator() = default;
+
+  template<class U>
+  aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+  {}
+
+  /// Return the number of bytes allocated for `n` elements, i.e. `n * sizeof(T)` rounded up to `Alignment`.
+  static constexpr size_t padded_size(size_t n)
+  {
+    return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+  }
+
+  T* allocate(size_t n)
+  {
+    return static_cast<T*>(::operator new(padded_size(n), std::align_val_t(Alignment)));
+  }
+
+  void deallocate(T* p, size_t n) noexcept
+  {
+    ::operator delete(p, padded_size(n), std::align_val_t(Alignment));
+  }
+
+  template<class U>
+  bool operator==(const aligned_allocator<U, Alignment>&) const noexcept { return true; }
+};
+
+/// `vector` with storage aligned and padded to `Alignment` bytes.
+/**
+ * Loops over the whole vector may use `VectorResidualLoop` without reading or writing beyond the allocation, and the
+ * policy `aligned_access` doesn't need to peel iterations, if the loop starts at 0.
+ */
+template<class T, size_t Alignment = 64>
+using aligned_vector = SimdIndexOperator<std::vector<T, aligned_allocator<T, Alignment>>>;
+
 } //namespace simd_access
 
 #endif //SIMD_ACCESS_VECTOR
@@ -1,5 +1,6 @@
 
 #include <gtest/gtest.h>
+#include <vector>
 
 #include "simd_access/simd_access.hpp"
 #include "simd_access/simd_loop.hpp"
@@ -87,3 +88,40 @@ TEST(AosTest, IndirectAddition)
     EXPECT_EQ(dest[i].y, expected_result.y);
   }
 }
+
+TEST(AosTest, MaskedResidualAddition)
+{
+  static constexpr size_t size = 11;
+  std::vector<Point<double>> src1(size), src2(size), dest(size, Point<double>{ -1.0, -1.0 });
+  std::vector<int> indices(size);
+  for (int i = 0; i < size; ++i)
+  {
+    src1[i] = Point<double>{ double(i), i * 3.0 };
+    src2[i] = Point<double>{ i * 2.0, i * 4.0 };
+    indices[i] = int(size) - 1 - i;
+  }
+
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+
+  simd_access::loop<vec_size>(size_t(0), size, [&](auto i)
+    {
+      SIMD_ACCESS(dest, i) = SIMD_ACCESS(src1, i) + SIMD_ACCESS(src2, i);
+    }, simd_access::MaskedResidualLoop);
+
+  for (int i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(dest[i].x, i * 3);
+    EXPECT_EQ(dest[i].y, i * 7);
+  }
+
+  simd_access::loop<vec_size>(indices.begin(), indices.end(), [&](auto i)
+    {
+      SIMD_ACCESS(dest, i) = SIMD_ACCESS(src1, i) + SIMD_ACCESS(dest, i);
+    }, simd_access::MaskedResidualLoop);
+
+  for (int i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(dest[i].x, i * 4);
+    EXPECT_EQ(dest[i].y, i * 10);
+  }
+}
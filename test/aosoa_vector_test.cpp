@@ -0,0 +1,138 @@
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/aosoa_vector.hpp"
+#include "particle.hpp"
+
+
+TEST(AosoaVector, ScalarAccess)
+{
+  constexpr int lanes = 4;
+  simd_access::aosoa_vector<Particle<double>, lanes> particles(10);
+  EXPECT_EQ(particles.size(), 10);
+  fill(particles);
+  particles.push_back(Particle<double>{ 10.0, { 1010.0, 2010.0 } });
+  EXPECT_EQ(particles.size(), 11);
+
+  const auto& cparticles = particles;
+  for (int i = 0; i < particles.size(); ++i)
+  {
+    Particle<double> p = cparticles[i];
+    EXPECT_EQ(p.x, i);
+    EXPECT_EQ(p.v[0], i + 1000);
+    EXPECT_EQ(SIMD_ACCESS(cparticles, i, .v[1]), i + 2000);
+  }
+  auto p = SIMD_ACCESS_V(particles, 7);
+  static_assert(std::is_same_v<decltype(p), Particle<double>>);
+  EXPECT_EQ(p.v[0], 1007);
+  // the members of a block are stored in separate arrays of `lanes` entries, the blocks are consecutive
+  EXPECT_EQ(&SIMD_ACCESS(particles, 1, .v[0]), &SIMD_ACCESS(particles, 0, .v[0]) + 1);
+  EXPECT_EQ(&SIMD_ACCESS(particles, 0, .v[0]), &SIMD_ACCESS(particles, 0, .x) + lanes);
+  EXPECT_EQ(&SIMD_ACCESS(particles, lanes, .x), &SIMD_ACCESS(particles, 0, .x) + 3 * lanes);
+
+  SIMD_ACCESS(particles, 2, .v[1]) = -1;
+  particles[5] = particles[2];
+  EXPECT_EQ(SIMD_ACCESS(particles, 5, .x), 2);
+  EXPECT_EQ(SIMD_ACCESS(particles, 5, .v[1]), -1);
+}
+
+TEST(AosoaVector, MemberAccess)
+{
+  static constexpr size_t size = 103;
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<Particle<double>> aos(size);
+  simd_access::aosoa_vector<Particle<double>, 2 * vec_size> aosoa(size);
+  fill(aos);
+  fill(aosoa);
+
+  move<vec_size>(aos, 0.5);
+  move<vec_size>(aosoa, 0.5);
+
+  // indices crossing the blocks
+  simd_access::loop<vec_size>(1, size, [&](auto i)
+    {
+      SIMD_ACCESS(aos, i, .v[0]) -= SIMD_ACCESS_V(aos, i, .x);
+      SIMD_ACCESS(aosoa, i, .v[0]) -= SIMD_ACCESS_V(aosoa, i, .x);
+    }, simd_access::MaskedResidualLoop);
+  // strided indices, whose lanes are in one block, but not consecutive
+  simd_access::loop<vec_size>(1, size, [&](auto i)
+    {
+      SIMD_ACCESS(aos, i, .v[1]) = SIMD_ACCESS_V(aos, i, .x);
+      SIMD_ACCESS(aosoa, i, .v[1]) = SIMD_ACCESS_V(aosoa, i, .x);
+    }, simd_access::MaskedResidualLoop, simd_access::Stride<2>);
+
+  for (int i = 0; i < size; ++i)
+  {
+    Particle<double> p = aosoa[i];
+    EXPECT_EQ(p.x, aos[i].x);
+    EXPECT_EQ(p.v[0], aos[i].v[0]);
+    EXPECT_EQ(p.v[1], aos[i].v[1]);
+  }
+}
+
+TEST(AosoaVector, AlignedAccess)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr int lanes = 2 * vec_size;
+  simd_access::aosoa_vector<Particle<double>, lanes> aosoa(5 * lanes);
+  using location_type = simd_access::aosoa_location<double, lanes, simd_access::index<vec_size, size_t>>;
+  auto is_aligned = [&](size_t i)
+    {
+      location_type location{&SIMD_ACCESS(aosoa, 0, .v[1]), aosoa.member_stride(0.0), {i}};
+      return location.visit([](const auto& member_location)
+        {
+          return requires { member_location.location_; };
+        });
+    };
+  // chunks starting at a multiple of the vector size in a block are aligned
+  EXPECT_TRUE(is_aligned(0));
+  EXPECT_TRUE(is_aligned(vec_size));
+  EXPECT_TRUE(is_aligned(3 * lanes + vec_size));
+  if constexpr (vec_size > 1)
+  {
+    EXPECT_FALSE(is_aligned(1));
+    EXPECT_FALSE(is_aligned(lanes + 1));
+  }
+}
+
+TEST(AosoaVector, StructureAccess)
+{
+  static constexpr size_t size = 103;
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  simd_access::aosoa_vector<Particle<double>, vec_size> src(size), dest(size), indirect_dest(size);
+  fill(src);
+  std::vector<int> reversed(size);
+  for (int i = 0; i < size; ++i)
+  {
+    reversed[i] = size - 1 - i;
+  }
+  std::vector<int> duplicates(size, 0);
+
+  simd_access::loop<vec_size>(0, size, [&](auto i)
+    {
+      auto p = SIMD_ACCESS_V(src, i);
+      p.x = p.x + p.v[1];
+      SIMD_ACCESS(dest, i) = p;
+    }, simd_access::MaskedResidualLoop);
+  simd_access::loop_with_linear_index<vec_size>(reversed.cbegin(), reversed.cend(), [&](auto linear_i, auto i)
+    {
+      SIMD_ACCESS(indirect_dest, i) = SIMD_ACCESS_V(src, linear_i);
+    }, simd_access::MaskedResidualLoop);
+  // compound assignments with duplicate indices
+  simd_access::loop<vec_size>(duplicates.cbegin(), duplicates.cend(), [&](auto i)
+    {
+      SIMD_ACCESS(dest, i, .v[1]) += 1.0;
+    }, simd_access::MaskedResidualLoop);
+
+  for (int i = 0; i < size; ++i)
+  {
+    Particle<double> p = dest[i], q = indirect_dest[size - 1 - i];
+    EXPECT_EQ(p.x, 2 * i + 2000);
+    EXPECT_EQ(p.v[0], i + 1000);
+    EXPECT_EQ(p.v[1], i == 0 ? 2000 + size : i + 2000);
+    EXPECT_EQ(q.x, i);
+    EXPECT_EQ(q.v[1], i + 2000);
+  }
+}
@@ -0,0 +1,133 @@
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/bit_view.hpp"
+
+namespace {
+
+template<class WordType>
+std::vector<WordType> make_words(const std::vector<bool>& flags)
+{
+  std::vector<WordType> words(simd_access::bit_view<WordType>::word_count(flags.size()));
+  auto view = simd_access::make_bit_view(words.data(), flags.size());
+  for (size_t i = 0; i < flags.size(); ++i)
+  {
+    view[i] = flags[i];
+  }
+  return words;
+}
+
+template<class WordType, class ResidualLoopPolicyType>
+void test_load(size_t start, size_t size, ResidualLoopPolicyType residualLoopPolicy)
+{
+  constexpr size_t vec_size = 8;
+  std::vector<bool> flags(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    flags[i] = (i * 7) % 3 == 0 || i % 11 == 0;
+  }
+  // exactly sized arrays, so that out-of-bounds accesses are detected by sanitizers
+  auto words = make_words<WordType>(flags);
+  const auto active = simd_access::make_bit_view(std::as_const(words).data(), size);
+  std::vector<WordType> copied_words(words.size(), 0);
+  auto copy = simd_access::make_bit_view(copied_words.data(), size);
+  std::vector<float> x(size, 0.0f);
+  simd_access::loop<vec_size>(start, size, [&](auto i)
+    {
+      SIMD_ACCESS(copy, i) = SIMD_ACCESS_V(active, i);
+    }, residualLoopPolicy);
+  simd_access::loop<vec_size>(start, size, [&](auto i)
+    {
+      where(SIMD_ACCESS_V(active, i), SIMD_ACCESS(x, i)) = SIMD_ACCESS_V(x, i) + 1.0f;
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < size; ++i)
+  {
+    const bool expected = i >= start && flags[i];
+    EXPECT_EQ(bool(copy[i]), expected) << "start " << start << ", size " << size << ", i " << i;
+    EXPECT_EQ(x[i], expected ? 1.0f : 0.0f) << "start " << start << ", size " << size << ", i " << i;
+  }
+}
+
+}
+
+
+TEST(BitView, Load)
+{
+  for (size_t size : { 1, 7, 8, 63, 64, 65, 130 })
+  {
+    for (size_t start : { 0, 3, 60 })
+    {
+      if (start < size)
+      {
+        test_load<std::uint64_t>(start, size, simd_access::MaskedResidualLoop);
+        test_load<std::uint32_t>(start, size, simd_access::ScalarResidualLoop);
+        test_load<std::uint8_t>(start, size, simd_access::MaskedResidualLoop);
+      }
+    }
+  }
+
+  // indirect indices crossing words
+  constexpr int vec_size = 8;
+  std::vector<bool> flags(200);
+  for (size_t i = 0; i < flags.size(); ++i)
+  {
+    flags[i] = i % 3 == 1;
+  }
+  const auto words = make_words<std::uint64_t>(flags);
+  const auto view = simd_access::make_bit_view(words.data(), flags.size());
+  const int indices[vec_size] = { 199, 0, 1, 64, 63, 100, 100, 130 };
+  simd_access::index_array<vec_size, const int*> indirect{indices};
+  auto mask = SIMD_ACCESS_V(view, indirect);
+  for (int i = 0; i < vec_size; ++i)
+  {
+    EXPECT_EQ(mask[i], flags[indices[i]]) << "i " << i;
+  }
+}
+
+TEST(BitView, Store)
+{
+  constexpr size_t vec_size = 8;
+  constexpr size_t size = 203;
+  std::vector<float> x(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    x[i] = float((i * 37) % 17);
+  }
+  std::vector<std::uint64_t> words(simd_access::bit_view<>::word_count(size), ~std::uint64_t(0));
+  auto flags = simd_access::make_bit_view(words.data(), size);
+  simd_access::loop<vec_size>(5, size, [&](auto i)
+    {
+      SIMD_ACCESS(flags, i) = SIMD_ACCESS_V(x, i) > 8.0f;
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(bool(flags[i]), i < 5 || x[i] > 8.0f) << "i " << i;
+  }
+  // bits beyond the end are untouched
+  EXPECT_EQ(words.back() >> (size % 64), ~std::uint64_t(0) >> (size % 64));
+
+  // masked stores of a broadcasted value
+  simd_access::index<vec_size> index{60};
+  where(SIMD_ACCESS_V(x, index) == 0.0f, SIMD_ACCESS(flags, index)) = true;
+  for (size_t i = 60; i < 60 + vec_size; ++i)
+  {
+    EXPECT_EQ(bool(flags[i]), x[i] > 8.0f || x[i] == 0.0f) << "i " << i;
+  }
+
+  // indirect indices, several of them in the same word
+  std::vector<std::uint8_t> bytes(4, 0);
+  auto small_flags = simd_access::make_bit_view(bytes.data(), 32);
+  simd_access::index_array<vec_size, std::array<int, vec_size>> indirect{{ 0, 2, 3, 9, 31, 30, 8, 17 }};
+  SIMD_ACCESS(small_flags, indirect) = stdx::fixed_size_simd<int, vec_size>([](int i) { return i; }) != 2;
+  EXPECT_EQ(bytes, (std::vector<std::uint8_t>{ 0b101, 0b11, 0b10, 0b11000000 }));
+  auto loaded = SIMD_ACCESS_V(small_flags, indirect);
+  EXPECT_EQ(simd_access::mask_to_bits<vec_size>(loaded), 0b11111011u);
+  SIMD_ACCESS(small_flags, 31) = false;
+  EXPECT_FALSE(SIMD_ACCESS_V(small_flags, 31));
+  EXPECT_EQ(bytes[3], 0b01000000);
+}
@@ -0,0 +1,143 @@
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/gather_plan.hpp"
+
+TEST(GatherPlan, Inspection)
+{
+  constexpr int vec_size = 4;
+  std::vector<int> indices{ 4, 5, 6, 7,  0, 2, 4, 6,  9, 3, 1, 0,  8, 1, 8, 2,  3, 3, 3, 3,  1, 2 };
+  simd_access::gather_plan<vec_size, std::vector<int>::const_iterator> plan(indices.cbegin(), indices.cend());
+
+  EXPECT_EQ(plan.chunk_count(), 5);
+  EXPECT_EQ(plan.kind(0), simd_access::chunk_kind::contiguous);
+  EXPECT_EQ(plan.kind(1), simd_access::chunk_kind::strided);
+  EXPECT_EQ(plan.stride(1), 2);
+  EXPECT_EQ(plan.kind(2), simd_access::chunk_kind::random);
+  EXPECT_EQ(plan.kind(3), simd_access::chunk_kind::random);
+  EXPECT_EQ(plan.kind(4), simd_access::chunk_kind::random);
+  EXPECT_FALSE(plan.has_duplicates(2));
+  EXPECT_TRUE(plan.has_duplicates(3));
+  EXPECT_TRUE(plan.has_duplicates(4));
+  EXPECT_EQ(plan.count(simd_access::chunk_kind::contiguous), 1);
+  EXPECT_EQ(plan.count(simd_access::chunk_kind::strided), 1);
+  EXPECT_EQ(plan.count(simd_access::chunk_kind::random), 3);
+  EXPECT_EQ(plan.duplicate_count(), 2);
+
+  EXPECT_EQ(plan.span(0), 3);
+  EXPECT_EQ(plan.span(1), 6);
+  EXPECT_EQ(plan.span(2), 9);
+  EXPECT_EQ(plan.span(4), 0);
+  EXPECT_EQ(plan.max_span(), 9);
+  EXPECT_TRUE(plan.is_local(3, 8));
+  EXPECT_FALSE(plan.is_local(2, 8));
+  EXPECT_EQ(plan.local_count(8), 4);
+  EXPECT_EQ(plan.local_count(4), 2);
+}
+
+TEST(GatherPlan, Loop)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr size_t size = 10 * vec_size + 3;
+  std::vector<double> src(size), dest(size, -1.0);
+  std::iota(src.begin(), src.end(), 0.0);
+  // reverse every other chunk, the others stay contiguous
+  std::vector<size_t> indices(size);
+  std::iota(indices.begin(), indices.end(), 0);
+  for (size_t i = vec_size; i + vec_size <= size; i += 2 * vec_size)
+  {
+    std::reverse(indices.begin() + i, indices.begin() + i + vec_size);
+  }
+  simd_access::gather_plan<vec_size, std::vector<size_t>::iterator> plan(indices.begin(), indices.end());
+  EXPECT_EQ(plan.count(simd_access::chunk_kind::contiguous), 5);
+
+  size_t contiguous_calls = 0;
+  for (int repetition = 0; repetition < 2; ++repetition)
+  {
+    simd_access::loop<vec_size>(plan, [&](auto i)
+      {
+        if constexpr (requires { i.to_simd(); })
+        {
+          ++contiguous_calls;
+        }
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) * 2;
+      });
+  }
+  EXPECT_EQ(contiguous_calls, 10);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(dest[i], i * 2);
+  }
+
+  std::vector<double> linear(size, -1.0);
+  simd_access::loop_with_linear_index<vec_size>(plan, [&](auto i, auto j)
+    {
+      SIMD_ACCESS(linear, i) = SIMD_ACCESS_V(src, j);
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(linear[i], indices[i]);
+  }
+}
+
+TEST(GatherPlan, StridedChunks)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  // chunks with the strides 1, 2, 3, 7 and -1 followed by a random chunk and residual indices
+  const std::ptrdiff_t strides[] = { 1, 2, 3, 7, -1 };
+  std::vector<size_t> indices;
+  for (auto stride : strides)
+  {
+    const size_t first = stride < 0 ? 10 * vec_size : 0;
+    for (size_t lane = 0; lane < vec_size; ++lane)
+    {
+      indices.push_back(size_t(std::ptrdiff_t(first) + std::ptrdiff_t(lane) * stride));
+    }
+  }
+  for (size_t lane = 0; lane < vec_size + 2; ++lane)
+  {
+    indices.push_back((lane * lane + 3) % (8 * vec_size));
+  }
+  simd_access::gather_plan<vec_size, std::vector<size_t>::const_iterator> plan(indices.cbegin(), indices.cend());
+  EXPECT_EQ(plan.count(simd_access::chunk_kind::strided), vec_size > 1 ? 4 : 0);
+
+  std::vector<double> src(10 * vec_size + 1), dest(indices.size(), -1.0);
+  std::iota(src.begin(), src.end(), 0.0);
+  int contiguous_calls = 0, pitched_calls = 0, runtime_strided_calls = 0, gathered_calls = 0;
+  simd_access::loop_with_linear_index<vec_size>(plan, [&](auto i, auto j)
+    {
+      using index_type = decltype(j);
+      if constexpr (std::is_same_v<index_type, simd_access::index<vec_size, size_t>>)
+      {
+        ++contiguous_calls;
+      }
+      else if constexpr (requires { index_type::stride(); })
+      {
+        ++pitched_calls;
+      }
+      else if constexpr (requires { j.stride_; })
+      {
+        ++runtime_strided_calls;
+      }
+      else if constexpr (!std::is_integral_v<index_type>)
+      {
+        ++gathered_calls;
+      }
+      SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, j) + 1;
+    });
+  if constexpr (vec_size > 1)
+  {
+    EXPECT_EQ(contiguous_calls, 1);
+    EXPECT_EQ(pitched_calls, 2);
+    EXPECT_EQ(runtime_strided_calls, 1);
+    EXPECT_EQ(gathered_calls, 2);
+  }
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    EXPECT_EQ(dest[i], indices[i] + 1);
+  }
+}
@@ -1,5 +1,6 @@
 
 #include <gtest/gtest.h>
+#include <type_traits>
 
 #include "simd_access/index.hpp"
 
@@ -31,3 +32,28 @@ TEST(Index, LinearTypeConvertion)
     EXPECT_EQ(value[i], i + 3);
   }
 }
+
+TEST(Index, Offset)
+{
+  constexpr size_t vec_size = 4;
+  simd_access::aligned_index<vec_size> index{8};
+  auto right = index + 1;
+  auto left = index - 2;
+  // shifted elements aren't aligned anymore
+  static_assert(std::is_same_v<decltype(right), simd_access::index<vec_size>>);
+  EXPECT_EQ(right.index_, 9);
+  EXPECT_EQ(left.index_, 6);
+
+  using mask_index_type = stdx::fixed_size_simd<int, vec_size>;
+  simd_access::masked_index<vec_size, int> masked{3, mask_index_type([](int i) { return i; }) < 2};
+  auto masked_left = masked - 1;
+  static_assert(std::is_same_v<decltype(masked_left), decltype(masked)>);
+  EXPECT_EQ(masked_left.index_, 2);
+  EXPECT_EQ(stdx::popcount(masked_left.mask_), 2);
+
+  simd_access::index_nd<3, simd_access::index<vec_size>> index_3d{{1, 2}, {5}};
+  auto shifted = (index_3d + 1).shifted<0>(-1).shifted<1>(2);
+  EXPECT_EQ(shifted.outer_[0], 0);
+  EXPECT_EQ(shifted.outer_[1], 4);
+  EXPECT_EQ(shifted.inner_.index_, 6);
+}
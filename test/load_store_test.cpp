@@ -0,0 +1,622 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+
+namespace {
+
+template<class T>
+struct Triple
+{
+  T x, y, z;
+};
+
+template<class T, int Pitch>
+struct Members
+{
+  T m[Pitch];
+};
+
+template<int SimdSize, class T, int Pitch>
+inline auto simdized_value(const Members<T, Pitch>&)
+{
+  return Members<stdx::fixed_size_simd<T, SimdSize>, Pitch>();
+}
+
+template<class DestType, class SrcType, int Pitch, class FN>
+inline void simd_members(Members<DestType, Pitch>& d, const Members<SrcType, Pitch>& s, FN&& func)
+{
+  // reverse order to check the mapping of members to their memory location
+  for (int i = Pitch - 1; i >= 0; --i)
+  {
+    func(d.m[i], s.m[i]);
+  }
+}
+
+struct Mixed
+{
+  float f;
+  std::int32_t i;
+  std::uint32_t u;
+};
+
+template<int SimdSize>
+inline auto simdized_value(const Mixed&)
+{
+  struct SimdMixed
+  {
+    stdx::fixed_size_simd<float, SimdSize> f;
+    stdx::fixed_size_simd<std::int32_t, SimdSize> i;
+    stdx::fixed_size_simd<std::uint32_t, SimdSize> u;
+  };
+  return SimdMixed();
+}
+
+template<class SimdType, class FN>
+inline void simd_members(Mixed& d, const SimdType& s, FN&& func)
+{
+  func(d.f, s.f);
+  func(d.i, s.i);
+  func(d.u, s.u);
+}
+
+template<class SimdType, class FN>
+inline void simd_members(SimdType& d, const Mixed& s, FN&& func)
+{
+  func(d.f, s.f);
+  func(d.i, s.i);
+  func(d.u, s.u);
+}
+
+template<class IndexType, class T, int SimdSize>
+void check_gather()
+{
+  std::vector<T> data(100);
+  std::vector<Triple<T>> triples(100);
+  for (int i = 0; i < 100; ++i)
+  {
+    data[i] = T(i * 3 + 1);
+    triples[i] = Triple<T>{ T(i), T(i + 1000), T(i + 2000) };
+  }
+  std::vector<IndexType> indices(SimdSize);
+  for (int i = 0; i < SimdSize; ++i)
+  {
+    indices[i] = IndexType((i * 37 + 11) % 100);
+  }
+
+  simd_access::index_array<SimdSize, const IndexType*> index{indices.data()};
+  stdx::fixed_size_simd<T, SimdSize> x_data = SIMD_ACCESS(data, index);
+  stdx::fixed_size_simd<T, SimdSize> x_triple = SIMD_ACCESS(triples, index, .y);
+  for (int i = 0; i < SimdSize; ++i)
+  {
+    EXPECT_EQ(x_data[i], data[indices[i]]);
+    EXPECT_EQ(x_triple[i], triples[indices[i]].y);
+  }
+}
+
+template<class IndexType, class T, int SimdSize>
+void check_masked_gather_scatter()
+{
+  constexpr int size = 50;
+  for (int active : { 1, SimdSize / 2, SimdSize - 1 })
+  {
+    std::vector<T> data(size);
+    std::vector<Triple<T>> triples(size);
+    for (int i = 0; i < size; ++i)
+    {
+      data[i] = T(i * 3 + 1);
+      triples[i] = Triple<T>{ T(i), T(i + 1000), T(i + 2000) };
+    }
+    // the index array ends after the active lanes
+    std::vector<IndexType> indices(active);
+    for (int i = 0; i < active; ++i)
+    {
+      indices[i] = IndexType((i * 37 + 11) % size);
+    }
+    auto lanes = stdx::fixed_size_simd<IndexType, SimdSize>([](auto i) { return IndexType(i); });
+    simd_access::masked_index_array<SimdSize, const IndexType*> index{indices.data(), lanes < IndexType(active)};
+
+    stdx::fixed_size_simd<T, SimdSize> x_data = SIMD_ACCESS_V(data, index);
+    stdx::fixed_size_simd<T, SimdSize> x_triple = SIMD_ACCESS_V(triples, index, .y);
+    for (int i = 0; i < SimdSize; ++i)
+    {
+      EXPECT_EQ(x_data[i], i < active ? data[indices[i]] : T(0));
+      EXPECT_EQ(x_triple[i], i < active ? triples[indices[i]].y : T(0));
+    }
+
+    SIMD_ACCESS(data, index) = x_data + T(1);
+    SIMD_ACCESS(triples, index, .z) = x_triple;
+    for (int i = 0; i < size; ++i)
+    {
+      bool is_indexed = std::find(indices.begin(), indices.end(), IndexType(i)) != indices.end();
+      EXPECT_EQ(data[i], T(i * 3 + 1 + (is_indexed ? 1 : 0)));
+      EXPECT_EQ(triples[i].z, is_indexed ? T(i + 1000) : T(i + 2000));
+    }
+
+    // pitched accesses at the end of an array
+    std::vector<Triple<T>> tail(active);
+    for (int i = 0; i < active; ++i)
+    {
+      tail[i] = Triple<T>{ T(i), T(i + 1000), T(i + 2000) };
+    }
+    simd_access::masked_index<SimdSize, IndexType> linear{0, lanes < IndexType(active)};
+    stdx::fixed_size_simd<T, SimdSize> y = SIMD_ACCESS_V(tail, linear, .y);
+    SIMD_ACCESS(tail, linear, .x) = y;
+    for (int i = 0; i < SimdSize; ++i)
+    {
+      EXPECT_EQ(y[i], i < active ? T(i + 1000) : T(0));
+    }
+    for (int i = 0; i < active; ++i)
+    {
+      EXPECT_EQ(tail[i].x, T(i + 1000));
+    }
+  }
+}
+
+template<class T, int Pitch, int SimdSize>
+void check_pitched_load()
+{
+  constexpr int size = 3 * SimdSize;
+  struct Element
+  {
+    T members[Pitch];
+  };
+  std::vector<Element> data(size);
+  for (int i = 0; i < size; ++i)
+  {
+    for (int m = 0; m < Pitch; ++m)
+    {
+      data[i].members[m] = T(i * Pitch + m);
+    }
+  }
+
+  for (int start : { 0, 1, size - SimdSize })
+  {
+    simd_access::index<SimdSize> index{size_t(start)};
+    for (int m = 0; m < Pitch; ++m)
+    {
+      stdx::fixed_size_simd<T, SimdSize> x = SIMD_ACCESS(data, index, .members[m]);
+      for (int i = 0; i < SimdSize; ++i)
+      {
+        EXPECT_EQ(x[i], data[start + i].members[m]);
+      }
+    }
+  }
+}
+
+
+template<class T, int Pitch, int SimdSize>
+void check_interleaved_store()
+{
+  constexpr int size = 3 * SimdSize;
+  using Element = Members<T, Pitch>;
+  for (int start : { 0, 1, size - SimdSize })
+  {
+    std::vector<Element> data(size, Element{});
+    simd_access::index<SimdSize> index{size_t(start)};
+    Members<stdx::fixed_size_simd<T, SimdSize>, Pitch> value;
+    for (int m = 0; m < Pitch; ++m)
+    {
+      value.m[m] = stdx::fixed_size_simd<T, SimdSize>([&](auto i) { return T(i * Pitch + m + 1); });
+    }
+    SIMD_ACCESS(data, index) = value;
+    for (int i = 0; i < size; ++i)
+    {
+      for (int m = 0; m < Pitch; ++m)
+      {
+        bool is_stored = i >= start && i < start + SimdSize;
+        EXPECT_EQ(data[i].m[m], is_stored ? T((i - start) * Pitch + m + 1) : T(0));
+      }
+    }
+  }
+}
+
+
+template<class T, int Pitch, int SimdSize>
+void check_transposed_load()
+{
+  constexpr int size = 3 * SimdSize;
+  std::vector<Members<T, Pitch>> data(size);
+  for (int i = 0; i < size; ++i)
+  {
+    for (int m = 0; m < Pitch; ++m)
+    {
+      data[i].m[m] = T(i * Pitch + m + 1);
+    }
+  }
+  for (int start : { 0, 1, size - SimdSize })
+  {
+    Members<stdx::fixed_size_simd<T, SimdSize>, Pitch> value =
+      SIMD_ACCESS_V(std::as_const(data), simd_access::index<SimdSize>{size_t(start)});
+    for (int m = 0; m < Pitch; ++m)
+    {
+      for (int i = 0; i < SimdSize; ++i)
+      {
+        EXPECT_EQ(value.m[m][i], data[start + i].m[m]);
+      }
+    }
+  }
+}
+
+}
+
+TEST(LoadStore, Gather)
+{
+  check_gather<int, double, 2>();
+  check_gather<int, double, 4>();
+  check_gather<int, double, 8>();
+  check_gather<int, float, 4>();
+  check_gather<int, float, 8>();
+  check_gather<int, float, 16>();
+  check_gather<size_t, double, 4>();
+  check_gather<size_t, double, 8>();
+  check_gather<size_t, float, 8>();
+  check_gather<unsigned, std::int64_t, 4>();
+  check_gather<std::int16_t, std::int32_t, 8>();
+  check_gather<std::uint8_t, std::int16_t, 8>();
+  check_gather<int, double, 3>();
+}
+
+TEST(LoadStore, PitchedLoad)
+{
+  check_pitched_load<double, 2, 2>();
+  check_pitched_load<double, 2, 4>();
+  check_pitched_load<double, 3, 4>();
+  check_pitched_load<double, 4, 8>();
+  check_pitched_load<double, 8, 8>();
+  check_pitched_load<float, 2, 8>();
+  check_pitched_load<float, 3, 8>();
+  check_pitched_load<float, 4, 16>();
+  check_pitched_load<float, 8, 16>();
+  check_pitched_load<std::int16_t, 3, 16>();
+  check_pitched_load<int, 5, 4>();
+}
+
+TEST(LoadStore, InterleavedStore)
+{
+  check_interleaved_store<double, 2, 2>();
+  check_interleaved_store<double, 2, 4>();
+  check_interleaved_store<double, 3, 4>();
+  check_interleaved_store<double, 4, 8>();
+  check_interleaved_store<float, 2, 8>();
+  check_interleaved_store<float, 3, 8>();
+  check_interleaved_store<float, 4, 16>();
+  check_interleaved_store<std::int16_t, 3, 16>();
+  check_interleaved_store<std::uint8_t, 4, 16>();
+  check_interleaved_store<int, 5, 4>();
+
+  constexpr int simd_size = 4;
+  std::vector<Mixed> data(simd_size + 1, Mixed{});
+  decltype(simdized_value<simd_size>(data[0])) value;
+  value.f = stdx::fixed_size_simd<float, simd_size>([](auto i) { return 0.5f + i; });
+  value.i = stdx::fixed_size_simd<std::int32_t, simd_size>([](auto i) { return -int(i); });
+  value.u = stdx::fixed_size_simd<std::uint32_t, simd_size>([](auto i) { return std::uint32_t(10 + i); });
+  SIMD_ACCESS(data, simd_access::index<simd_size>{1}) = value;
+  EXPECT_EQ(data[0].f, 0.0f);
+  EXPECT_EQ(data[0].u, 0u);
+  for (int i = 0; i < simd_size; ++i)
+  {
+    EXPECT_EQ(data[i + 1].f, 0.5f + i);
+    EXPECT_EQ(data[i + 1].i, -i);
+    EXPECT_EQ(data[i + 1].u, 10u + i);
+  }
+}
+
+TEST(LoadStore, TransposedLoad)
+{
+  check_transposed_load<double, 2, 2>();
+  check_transposed_load<double, 2, 4>();
+  check_transposed_load<double, 3, 4>();
+  check_transposed_load<double, 4, 4>();
+  check_transposed_load<double, 8, 4>();
+  check_transposed_load<double, 8, 8>();
+  check_transposed_load<float, 3, 8>();
+  check_transposed_load<float, 4, 16>();
+  check_transposed_load<std::int16_t, 3, 16>();
+  check_transposed_load<std::uint8_t, 4, 16>();
+  check_transposed_load<int, 5, 4>();
+
+  constexpr int simd_size = 4;
+  std::vector<Mixed> data(simd_size + 1);
+  for (int i = 0; i <= simd_size; ++i)
+  {
+    data[i] = Mixed{ 0.5f + i, -i, 10u + i };
+  }
+  decltype(simdized_value<simd_size>(data[0])) value = SIMD_ACCESS_V(data, simd_access::index<simd_size>{1});
+  for (int i = 0; i < simd_size; ++i)
+  {
+    EXPECT_EQ(value.f[i], data[i + 1].f);
+    EXPECT_EQ(value.i[i], data[i + 1].i);
+    EXPECT_EQ(value.u[i], data[i + 1].u);
+  }
+}
+
+TEST(LoadStore, MaskedGatherScatter)
+{
+  check_masked_gather_scatter<int, double, 2>();
+  check_masked_gather_scatter<int, double, 4>();
+  check_masked_gather_scatter<int, double, 8>();
+  check_masked_gather_scatter<int, float, 4>();
+  check_masked_gather_scatter<int, float, 8>();
+  check_masked_gather_scatter<int, float, 16>();
+  check_masked_gather_scatter<size_t, double, 4>();
+  check_masked_gather_scatter<size_t, double, 8>();
+  check_masked_gather_scatter<size_t, float, 8>();
+  check_masked_gather_scatter<unsigned, std::int64_t, 4>();
+  check_masked_gather_scatter<std::int16_t, std::int32_t, 8>();
+  check_masked_gather_scatter<int, double, 3>();
+}
+
+TEST(LoadStore, WhereAccess)
+{
+  constexpr int simd_size = 4;
+  std::vector<double> data{ 1, 2, 3, 4, 5, 6 };
+  std::vector<Triple<double>> triples(6, Triple<double>{ 1, 2, 3 });
+  simd_access::index<simd_size> index{1};
+  auto x = SIMD_ACCESS_V(data, index);
+  where(x > 3, SIMD_ACCESS(data, index)) = x * 10;
+  where(x < 3, SIMD_ACCESS(triples, index, .y)) += x;
+  EXPECT_EQ(data, (std::vector<double>{ 1, 2, 3, 40, 50, 6 }));
+  for (int i = 0; i < 6; ++i)
+  {
+    EXPECT_EQ(triples[i].y, i == 1 ? 4.0 : 2.0);
+  }
+
+  // where with a masked index applies both masks
+  auto lanes = stdx::fixed_size_simd<size_t, simd_size>([](auto i) { return size_t(i); });
+  simd_access::masked_index<simd_size> masked{4, lanes < 2};
+  auto y = SIMD_ACCESS_V(data, masked);
+  where(y < 10, SIMD_ACCESS(data, masked)) -= y;
+  EXPECT_EQ(data, (std::vector<double>{ 1, 2, 3, 40, 50, 0 }));
+
+  const int indices[] = { 5, 0 };
+  simd_access::masked_index_array<simd_size, const int*> indirect{indices, lanes < 2};
+  where(SIMD_ACCESS_V(triples, indirect, .x) > 0, SIMD_ACCESS(triples, indirect, .z)) = SIMD_ACCESS_V(data, indirect);
+  EXPECT_EQ(triples[5].z, 0.0);
+  EXPECT_EQ(triples[0].z, 1.0);
+  EXPECT_EQ(triples[1].z, 3.0);
+}
+
+template<class IndexType, class T, int simd_size>
+void check_scatter_add()
+{
+  std::vector<T> data(simd_size, T(1)), expected_data = data;
+  std::vector<Triple<T>> triples(simd_size, Triple<T>{ T(1), T(2), T(3) }), expected_triples = triples;
+  simd_access::index_array<simd_size, std::array<IndexType, simd_size>> index;
+  for (int i = 0; i < simd_size; ++i)
+  {
+    // every lane except lane 1 has the index 0
+    index.index_[i] = IndexType(i == 1 ? 1 : 0);
+  }
+  auto contrib = stdx::fixed_size_simd<T, simd_size>([](auto i) { return T(i + 1); });
+  SIMD_ACCESS(data, index) += contrib;
+  SIMD_ACCESS(triples, index, .y) -= contrib;
+  SIMD_ACCESS(triples, index, .z) *= T(2);
+  for (int i = 0; i < simd_size; ++i)
+  {
+    expected_data[index.index_[i]] += contrib[i];
+    expected_triples[index.index_[i]].y -= contrib[i];
+    expected_triples[index.index_[i]].z *= T(2);
+  }
+
+  // inactive lanes are not accumulated, even if their index is duplicated
+  auto lanes = stdx::fixed_size_simd<IndexType, simd_size>([](auto i) { return IndexType(i); });
+  simd_access::masked_index_array<simd_size, const IndexType*> masked{index.index_.data(), lanes != 0};
+  SIMD_ACCESS(data, masked) += contrib;
+  for (int i = 1; i < simd_size; ++i)
+  {
+    expected_data[index.index_[i]] += contrib[i];
+  }
+
+  for (int i = 0; i < simd_size; ++i)
+  {
+    EXPECT_EQ(data[i], expected_data[i]);
+    EXPECT_EQ(triples[i].y, expected_triples[i].y);
+    EXPECT_EQ(triples[i].z, expected_triples[i].z);
+  }
+}
+
+TEST(LoadStore, ScatterAdd)
+{
+  check_scatter_add<int, double, 2>();
+  check_scatter_add<int, double, 4>();
+  check_scatter_add<int, double, 8>();
+  check_scatter_add<int, float, 8>();
+  check_scatter_add<int, float, 16>();
+  check_scatter_add<size_t, double, 4>();
+  check_scatter_add<size_t, double, 8>();
+  check_scatter_add<std::int64_t, std::int32_t, 4>();
+  check_scatter_add<std::int16_t, std::int32_t, 8>();
+  check_scatter_add<int, double, 3>();
+}
+
+namespace {
+
+template<int SimdSize, class T>
+inline auto simdized_value(const Triple<T>&)
+{
+  return Triple<stdx::fixed_size_simd<T, SimdSize>>();
+}
+
+template<class DestType, class SrcType, class FN>
+inline void simd_members(Triple<DestType>& d, const Triple<SrcType>& s, FN&& func)
+{
+  func(d.x, s.x);
+  func(d.y, s.y);
+  func(d.z, s.z);
+}
+
+template<int SimdSize, class Encoding>
+void check_half_precision(float (*to_float)(std::uint16_t))
+{
+  // all finite bit patterns survive a round trip, vector and scalar conversions agree
+  std::vector<std::uint16_t> bits(1 << 16), round_trip(bits.size());
+  std::iota(bits.begin(), bits.end(), std::uint16_t(0));
+  std::vector<float> values(bits.size());
+  simd_access::loop<SimdSize>(0, bits.size(), [&](auto i)
+    {
+      SIMD_ACCESS(values, i) = simd_access::to_simd(simd_access::as<float, Encoding>(SIMD_ACCESS(bits, i)));
+      simd_access::as<float, Encoding>(SIMD_ACCESS(round_trip, i)) = SIMD_ACCESS_V(values, i);
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < bits.size(); ++i)
+  {
+    float expected = to_float(bits[i]);
+    if (expected == expected)
+    {
+      EXPECT_EQ(values[i], expected);
+      EXPECT_EQ(round_trip[i], bits[i]);
+    }
+    else
+    {
+      EXPECT_NE(values[i], values[i]);
+      EXPECT_NE(to_float(round_trip[i]), to_float(round_trip[i]));
+    }
+  }
+
+  // values between two representable values are rounded to nearest even
+  std::vector<float> inputs(SimdSize * 64);
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    inputs[i] = std::ldexp(1.0f + float(i) / float(inputs.size()), int(i % 40) - 20) * (i % 3 == 0 ? -1 : 1);
+  }
+  std::vector<std::uint16_t> encoded(inputs.size());
+  simd_access::loop<SimdSize>(0, inputs.size(), [&](auto i)
+    {
+      simd_access::as<double, Encoding>(SIMD_ACCESS(encoded, i)) =
+        simd_access::to_simd(simd_access::as<double>(SIMD_ACCESS(inputs, i)));
+    });
+  for (size_t i = 0; i < inputs.size(); ++i)
+  {
+    std::uint16_t scalar;
+    Encoding::encode(scalar, inputs[i]);
+    EXPECT_EQ(encoded[i], scalar);
+    float lower = to_float(std::uint16_t(scalar - 1)), nearest = to_float(scalar);
+    float upper = to_float(std::uint16_t(scalar + 1));
+    if (std::isfinite(nearest))
+    {
+      EXPECT_LE(std::abs(inputs[i] - nearest), std::abs(inputs[i] - lower));
+      EXPECT_LE(std::abs(inputs[i] - nearest), std::abs(inputs[i] - upper));
+    }
+  }
+}
+
+}
+
+TEST(LoadStore, MixedPrecision)
+{
+  constexpr int simd_size = 8;
+  static constexpr size_t size = 103;
+  std::vector<float> data(size);
+  std::vector<double> expected(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    data[i] = float(i) + 0.25f;
+    expected[i] = 2.0 * double(data[i]) + 0x1p-30;
+  }
+
+  // the loaded values are double, the stored values are rounded to float
+  simd_access::loop<simd_size>(0, size, [&](auto i)
+    {
+      auto x = simd_access::to_simd(simd_access::as<double>(SIMD_ACCESS(data, i)));
+      static_assert(std::is_same_v<decltype(x), stdx::fixed_size_simd<double, simd_size>>);
+      simd_access::as<double>(SIMD_ACCESS(data, i)) = x + x + 0x1p-30;
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(data[i], float(expected[i]));
+  }
+
+  // compound assignments, scalar residual iterations and masked accesses
+  simd_access::loop<simd_size>(0, size, [&](auto i)
+    {
+      simd_access::as<double>(SIMD_ACCESS(data, i)) -= 0.5;
+    });
+  simd_access::index<simd_size> index{0};
+  auto x = simd_access::as<double>(SIMD_ACCESS(data, index)).to_simd();
+  where(x > 3.0, simd_access::as<double>(SIMD_ACCESS(data, index))) = x * 10.0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    double value = double(float(expected[i])) - 0.5;
+    EXPECT_EQ(data[i], float(i < simd_size && value > 3.0 ? value * 10.0 : value));
+  }
+
+  // indirect indices
+  const int indices[simd_size] = { 7, 3, 100, 0, 55, 3, 21, 14 };
+  simd_access::index_array<simd_size, const int*> indirect{indices};
+  stdx::fixed_size_simd<double, simd_size> y = simd_access::as<double>(SIMD_ACCESS(data, indirect));
+  for (int i = 0; i < simd_size; ++i)
+  {
+    EXPECT_EQ(y[i], double(data[indices[i]]));
+  }
+}
+
+TEST(LoadStore, HalfPrecision)
+{
+  check_half_precision<4, simd_access::float16_encoding>(simd_access::float16_to_float);
+  check_half_precision<8, simd_access::float16_encoding>(simd_access::float16_to_float);
+  check_half_precision<16, simd_access::float16_encoding>(simd_access::float16_to_float);
+  check_half_precision<5, simd_access::float16_encoding>(simd_access::float16_to_float);
+  check_half_precision<8, simd_access::bfloat16_encoding>(simd_access::bfloat16_to_float);
+  check_half_precision<16, simd_access::bfloat16_encoding>(simd_access::bfloat16_to_float);
+  check_half_precision<5, simd_access::bfloat16_encoding>(simd_access::bfloat16_to_float);
+
+#ifdef __FLT16_MANT_DIG__
+  // the scalar conversions agree with the compiler's half precision type
+  for (std::uint32_t bits = 0; bits < (1u << 16); ++bits)
+  {
+    float value = simd_access::float16_to_float(std::uint16_t(bits));
+    float reference = float(std::bit_cast<_Float16>(std::uint16_t(bits)));
+    EXPECT_TRUE(value == reference || (value != value && reference != reference));
+    float between = std::nextafter(value, value + 1.0f);
+    if (std::isfinite(between))
+    {
+      EXPECT_EQ(simd_access::float_to_float16(between), std::bit_cast<std::uint16_t>(_Float16(between)));
+    }
+  }
+#endif
+}
+
+TEST(LoadStore, MixedPrecisionStructure)
+{
+  constexpr int simd_size = 4;
+  static constexpr size_t size = 11;
+  std::vector<Triple<float>> triples(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    triples[i] = Triple<float>{ float(i), float(i) + 0.5f, -float(i) - 1.0f };
+  }
+
+  simd_access::loop<simd_size>(0, size, [&](auto i)
+    {
+      auto p = simd_access::to_simd(simd_access::as<Triple<double>>(SIMD_ACCESS(triples, i)));
+      p.x = p.x + p.y * 2.0;
+      p.z = p.z * 2.0 + 0x1p-40;
+      simd_access::as<Triple<double>>(SIMD_ACCESS(triples, i)) = p;
+    }, simd_access::MaskedResidualLoop);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(triples[i].x, float(3 * i + 1));
+    EXPECT_EQ(triples[i].y, float(i) + 0.5f);
+    EXPECT_EQ(triples[i].z, -float(2 * i + 2));
+  }
+
+  // indirect indices and scalar accesses
+  const int indices[simd_size] = { 9, 2, 2, 5 };
+  simd_access::index_array<simd_size, const int*> indirect{indices};
+  auto q = simd_access::as<Triple<double>>(SIMD_ACCESS(triples, indirect)).to_simd();
+  static_assert(std::is_same_v<decltype(q), Triple<stdx::fixed_size_simd<double, simd_size>>>);
+  for (int i = 0; i < simd_size; ++i)
+  {
+    EXPECT_EQ(q.y[i], double(triples[indices[i]].y));
+  }
+  Triple<double> s = simd_access::as<Triple<double>>(triples[3]);
+  simd_access::as<Triple<double>>(triples[4]) = s;
+  EXPECT_EQ(triples[4].x, 10.0f);
+  EXPECT_EQ(triples[4].z, -8.0f);
+}
@@ -2,11 +2,14 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 #include <numeric>
 #include <random>
 
 #include "simd_access/simd_access.hpp"
+#include "simd_access/row_major_view.hpp"
 #include "simd_access/simd_loop.hpp"
+#include "simd_access/vector.hpp"
 
 namespace {
 
@@ -117,3 +120,459 @@ TEST(Loop, ResidualLoop)
   }
 }
 
+TEST(Loop, MaskedResidualLoop)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (size_t size : { size_t(1), vec_size - 1, 2 * vec_size + 1, size_t(TestData::size) })
+  {
+    // exactly sized arrays, so that out-of-bounds accesses are detected by sanitizers
+    std::vector<double> src(size), dest(size, -1.0);
+    std::vector<TestStruct> src_s(size), dest_s(size, TestStruct{ -1.0, { -1.0 } });
+    std::vector<int> indices(size);
+    std::iota(src.begin(), src.end(), 0.0);
+    std::iota(indices.begin(), indices.end(), 0);
+    std::mt19937 g(1);
+    std::shuffle(indices.begin(), indices.end(), g);
+    for (size_t i = 0; i < size; ++i)
+    {
+      src_s[i] = TestStruct{ double(i), { double(i + 1) } };
+    }
+
+    int calls = 0;
+    simd_access::loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        static_assert(!std::is_integral_v<decltype(i)>);
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS(src, i) * 2;
+        SIMD_ACCESS(dest_s, i, .x) = SIMD_ACCESS(src_s, i, .y[0]) + SIMD_ACCESS(src_s, i, .x);
+        ++calls;
+      }, simd_access::MaskedResidualLoop);
+    EXPECT_EQ(calls, (size + vec_size - 1) / vec_size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i * 2);
+      EXPECT_EQ(dest_s[i].x, i * 2 + 1);
+      EXPECT_EQ(dest_s[i].y[0], -1.0);
+    }
+
+    simd_access::loop<vec_size>(indices.begin(), indices.end(), [&](auto i)
+      {
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS(src, i) + 1;
+      }, simd_access::MaskedResidualLoop);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i + 1);
+    }
+
+    simd_access::loop_with_linear_index<vec_size>(indices.cbegin(), indices.cend(), [&](auto linear_i, auto i)
+      {
+        SIMD_ACCESS(dest, linear_i) = SIMD_ACCESS_V(src, i);
+        SIMD_ACCESS(dest_s, i, .y[0]) = SIMD_ACCESS_V(src, linear_i);
+      }, simd_access::MaskedResidualLoop);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], indices[i]);
+      EXPECT_EQ(dest_s[indices[i]].y[0], i);
+    }
+  }
+}
+
+TEST(Loop, ContiguityCheck)
+{
+  TestData src(true), dest(false);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  // a mostly sorted index list: only the second chunk is reversed
+  std::vector<int> indices(src.size);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::reverse(indices.begin() + vec_size, indices.begin() + 2 * vec_size);
+
+  simd_access::contiguity_counter counter;
+  size_t contiguous_calls = 0;
+  simd_access::loop<vec_size>(indices.begin(), indices.end(), [&](auto i)
+    {
+      if constexpr (requires { i.to_simd(); })
+      {
+        ++contiguous_calls;
+      }
+      SIMD_ACCESS(dest.a, i) = SIMD_ACCESS_V(src.a, i) + 1;
+    }, simd_access::ScalarResidualLoop, simd_access::ContiguityCheckT{&counter});
+  EXPECT_EQ(counter.chunks_, src.size / vec_size);
+  EXPECT_EQ(counter.contiguous_chunks_, counter.chunks_ - 1);
+  EXPECT_EQ(contiguous_calls, counter.contiguous_chunks_);
+  EXPECT_DOUBLE_EQ(counter.hit_rate(), double(counter.chunks_ - 1) / counter.chunks_);
+  for (int i = 0; i < src.size; ++i)
+  {
+    EXPECT_EQ(dest.a[i], i + 1);
+  }
+
+  simd_access::loop_with_linear_index<vec_size>(indices.begin(), indices.end(), [&](auto i, auto j)
+    {
+      SIMD_ACCESS(dest.v, i) = SIMD_ACCESS_V(src.a, j);
+    }, simd_access::MaskedResidualLoop, simd_access::ContiguityCheck);
+  for (int i = 0; i < src.size; ++i)
+  {
+    EXPECT_EQ(dest.v[i], indices[i]);
+  }
+}
+
+TEST(Loop, Prefetch)
+{
+  TestData src(true), dest(false);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<int> indices(src.size);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937(3));
+
+  simd_access::contiguity_counter counter;
+  simd_access::loop_with_linear_index<vec_size>(indices.begin(), indices.end(), [&](auto i, auto j)
+    {
+      SIMD_ACCESS(dest.v, i) = SIMD_ACCESS_V(src.a, j) + SIMD_ACCESS_V(src.s, j, .x);
+    }, simd_access::ScalarResidualLoop, simd_access::prefetch<2>(4, src.a, src.s),
+    simd_access::ContiguityCheckT{&counter});
+  EXPECT_EQ(counter.chunks_, src.size / vec_size);
+  for (int i = 0; i < src.size; ++i)
+  {
+    EXPECT_EQ(dest.v[i], 2 * indices[i]);
+  }
+}
+
+TEST(Loop, StreamingStore)
+{
+  TestData src(true), dest(false);
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (int start : { 0, 1, 3 })
+  {
+    std::fill(dest.v.begin(), dest.v.end(), -1.0);
+    int unaligned_calls = 0;
+    simd_access::loop<vec_size>(start, src.size, [&](auto i)
+      {
+        if constexpr (!std::is_integral_v<decltype(i)>)
+        {
+          static_assert(std::is_same_v<decltype(i), simd_access::streaming_index<vec_size, size_t>>);
+          unaligned_calls += reinterpret_cast<std::uintptr_t>(&dest.v[i.index_]) % sizeof(double[vec_size]) != 0;
+        }
+        SIMD_ACCESS(dest.v, i) = SIMD_ACCESS_V(src.a, i) * 2;
+        SIMD_ACCESS(dest.s, i, .x) = SIMD_ACCESS_V(src.s, i, .x);
+      }, simd_access::ScalarResidualLoop, simd_access::streaming_store(dest.v));
+    EXPECT_EQ(unaligned_calls, 0);
+    for (int i = 0; i < src.size; ++i)
+    {
+      EXPECT_EQ(dest.v[i], i < start ? -1.0 : i * 2);
+      if (i >= start)
+      {
+        EXPECT_EQ(dest.s[i].x, i);
+      }
+    }
+
+    std::fill(dest.v.begin(), dest.v.end(), -1.0);
+    simd_access::loop<vec_size>(start, src.size, [&](auto i)
+      {
+        static_assert(!std::is_integral_v<decltype(i)>);
+        SIMD_ACCESS(dest.v, i) = SIMD_ACCESS_V(src.a, i) + 1;
+      }, simd_access::MaskedResidualLoop, simd_access::streaming_store(dest.v));
+    for (int i = 0; i < src.size; ++i)
+    {
+      EXPECT_EQ(dest.v[i], i < start ? -1.0 : i + 1);
+    }
+  }
+
+  simd_access::loop<vec_size>(0, src.size, [&](auto i)
+    {
+      SIMD_ACCESS(dest.a, i).streaming() = SIMD_ACCESS_V(src.a, i) * 3;
+    }, simd_access::MaskedResidualLoop);
+  simd_access::native_stream_fence();
+  for (int i = 0; i < src.size; ++i)
+  {
+    EXPECT_EQ(dest.a[i], i * 3);
+  }
+}
+
+TEST(Loop, AlignedAccess)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  struct alignas(64) AlignedData
+  {
+    alignas(64) double src[TestData::size];
+    alignas(64) double dest[TestData::size];
+    alignas(64) TestStruct s[TestData::size];
+  } data;
+  for (int i = 0; i < TestData::size; ++i)
+  {
+    data.src[i] = i;
+    data.s[i] = TestStruct{ double(i), { double(i + 1) } };
+  }
+  for (int start : { 0, 1, 3 })
+  {
+    std::fill(std::begin(data.dest), std::end(data.dest), -1.0);
+    int unaligned_calls = 0;
+    simd_access::loop<vec_size>(start, TestData::size, [&](auto i)
+      {
+        if constexpr (!std::is_integral_v<decltype(i)>)
+        {
+          EXPECT_TRUE((std::is_same_v<decltype(i), simd_access::aligned_index<vec_size, size_t>>));
+          unaligned_calls += reinterpret_cast<std::uintptr_t>(&data.src[i.index_]) % sizeof(double[vec_size]) != 0;
+        }
+        SIMD_ACCESS(data.dest, i) = SIMD_ACCESS_V(data.src, i) * 2 + SIMD_ACCESS_V(data.s, i, .y[0]);
+      }, simd_access::ScalarResidualLoop, simd_access::aligned_access(data.dest));
+    EXPECT_EQ(unaligned_calls, 0);
+    for (int i = 0; i < TestData::size; ++i)
+    {
+      EXPECT_EQ(data.dest[i], i < start ? -1.0 : i * 3 + 1);
+    }
+
+    std::fill(std::begin(data.dest), std::end(data.dest), -1.0);
+    simd_access::loop<vec_size>(start, TestData::size, [&](auto i)
+      {
+        static_assert(!std::is_integral_v<decltype(i)>);
+        SIMD_ACCESS(data.dest, i) = SIMD_ACCESS_V(data.src, i) + 1;
+      }, simd_access::MaskedResidualLoop, simd_access::aligned_access(data.dest));
+    for (int i = 0; i < TestData::size; ++i)
+    {
+      EXPECT_EQ(data.dest[i], i < start ? -1.0 : i + 1);
+    }
+  }
+}
+
+TEST(Loop, Unroll)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr int unroll = 4;
+  for (size_t size : { size_t(1), vec_size + 1, unroll * vec_size, 3 * unroll * vec_size - 1 })
+  {
+    // both arrays are aligned alike, since `aligned_access(dest)` also aligns the accesses to `src`
+    simd_access::aligned_vector<double> src(size), dest(size, -1.0);
+    std::iota(src.begin(), src.end(), 0.0);
+
+    // start and width of the simd calls
+    std::vector<std::pair<size_t, int>> simd_calls;
+    int scalar_calls = 0;
+    simd_access::loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        if constexpr (std::is_integral_v<decltype(i)>)
+        {
+          ++scalar_calls;
+        }
+        else
+        {
+          simd_calls.emplace_back(i.index_, i.size());
+        }
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) * 2;
+      }, simd_access::ScalarResidualLoop, simd_access::Unroll<unroll>);
+    size_t expected_start = 0;
+    for (auto [start, width] : simd_calls)
+    {
+      EXPECT_EQ(start, expected_start);
+      EXPECT_EQ(width, expected_start + unroll * vec_size <= size ? unroll * vec_size : vec_size);
+      expected_start += width;
+    }
+    EXPECT_EQ(expected_start, size / vec_size * vec_size);
+    EXPECT_EQ(scalar_calls, size % vec_size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i * 2);
+    }
+
+    std::fill(dest.begin(), dest.end(), -1.0);
+    simd_access::loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        static_assert(!std::is_integral_v<decltype(i)>);
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) + 1;
+      }, simd_access::MaskedResidualLoop, simd_access::Unroll<unroll>);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i + 1);
+    }
+
+    // aligned accesses are unrolled by calls with indices of `vec_size` elements
+    std::fill(dest.begin(), dest.end(), -1.0);
+    simd_access::loop<vec_size>(size_t(1), size, [&](auto i)
+      {
+        if constexpr (!std::is_integral_v<decltype(i)>)
+        {
+          EXPECT_TRUE((std::is_same_v<decltype(i), simd_access::aligned_index<vec_size, size_t>>));
+        }
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) + 2;
+      }, simd_access::ScalarResidualLoop, simd_access::aligned_access(dest), simd_access::Unroll<unroll>);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i == 0 ? -1.0 : i + 2);
+    }
+  }
+}
+
+TEST(Loop, Strided)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr size_t cols = 3;
+  auto test_column = [&](size_t rows, size_t col, auto residualLoopPolicy, auto stridePolicy)
+    {
+      // exactly sized row-major matrices, so that out-of-bounds accesses are detected by sanitizers
+      std::vector<double> src(rows * cols), dest(rows * cols, -1.0);
+      std::vector<TestStruct> dest_s(rows * cols, TestStruct{ -1.0, { -1.0 } });
+      std::iota(src.begin(), src.end(), 0.0);
+
+      size_t scalar_calls = 0;
+      simd_access::loop<vec_size>(col, rows * cols, [&](auto i)
+        {
+          if constexpr (std::is_integral_v<decltype(i)>)
+          {
+            ++scalar_calls;
+          }
+          SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, i) * 2;
+          SIMD_ACCESS(dest, i) += 1.0;
+          SIMD_ACCESS(dest_s, i, .y[0]) = SIMD_ACCESS_V(src, i);
+        }, residualLoopPolicy, stridePolicy);
+      EXPECT_EQ(scalar_calls, decltype(residualLoopPolicy)() == simd_access::ScalarResidualLoop ? rows % vec_size : 0);
+      for (size_t i = 0; i < rows * cols; ++i)
+      {
+        EXPECT_EQ(dest[i], i % cols == col ? i * 2 + 1 : -1.0) << "rows " << rows << ", i " << i;
+        EXPECT_EQ(dest_s[i].y[0], i % cols == col ? i : -1.0) << "rows " << rows << ", i " << i;
+        EXPECT_EQ(dest_s[i].x, -1.0);
+      }
+    };
+  for (size_t rows : { size_t(1), vec_size, 2 * vec_size + 1, size_t(TestData::size) })
+  {
+    for (size_t col = 0; col < cols; ++col)
+    {
+      test_column(rows, col, simd_access::ScalarResidualLoop, simd_access::Stride<cols>);
+      test_column(rows, col, simd_access::MaskedResidualLoop, simd_access::Stride<cols>);
+      test_column(rows, col, simd_access::ScalarResidualLoop, simd_access::stride(cols));
+      test_column(rows, col, simd_access::MaskedResidualLoop, simd_access::stride(cols));
+    }
+  }
+
+  // the lanes of the strided indices
+  simd_access::strided_index<4, 3> strided{2};
+  simd_access::runtime_strided_index<4> runtime_strided{2, 5};
+  for (int lane = 0; lane < 4; ++lane)
+  {
+    EXPECT_EQ(simd_access::get_index(strided, lane), 2 + 3 * lane);
+    EXPECT_EQ(strided.to_simd()[lane], 2 + 3 * lane);
+    EXPECT_EQ(simd_access::get_index(runtime_strided, lane), 2 + 5 * lane);
+    EXPECT_EQ((runtime_strided + 1).to_simd()[lane], 3 + 5 * lane);
+  }
+}
+
+TEST(Loop, MultiDimensional)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr size_t nk = 4, nj = 5, ni = 2 * vec_size + 3;
+  double src[nk][nj][ni], dest[nk][nj][ni];
+  for (size_t k = 0; k < nk; ++k)
+  {
+    for (size_t j = 0; j < nj; ++j)
+    {
+      for (size_t i = 0; i < ni; ++i)
+      {
+        src[k][j][i] = double((k * nj + j) * ni + i);
+      }
+    }
+  }
+  const std::array<size_t, 3> start{ 1, 1, 1 }, end{ nk, nj - 1, ni };
+  auto inside = [&](size_t k, size_t j, size_t i)
+    { return k >= start[0] && k < end[0] && j >= start[1] && j < end[1] && i >= start[2] && i < end[2]; };
+
+  // nested C arrays, visited points in the order of the tiles
+  std::fill_n(&dest[0][0][0], nk * nj * ni, -1.0);
+  std::vector<std::array<size_t, 3>> visited;
+  simd_access::loop_nd<vec_size>(start, end, [&](auto idx)
+    {
+      SIMD_ACCESS(dest, idx) = SIMD_ACCESS_V(src, idx) * 2;
+      for (int lane = 0; lane < idx.size(); ++lane)
+      {
+        size_t i;
+        if constexpr (std::is_integral_v<decltype(idx.inner_)>)
+        {
+          i = idx.inner_;
+        }
+        else
+        {
+          i = simd_access::get_index(idx.inner_, lane);
+        }
+        visited.push_back({ idx.outer_[0], idx.outer_[1], i });
+      }
+    }, simd_access::ScalarResidualLoop, simd_access::tiling(2, 2, vec_size + 1));
+  for (size_t k = 0; k < nk; ++k)
+  {
+    for (size_t j = 0; j < nj; ++j)
+    {
+      for (size_t i = 0; i < ni; ++i)
+      {
+        EXPECT_EQ(dest[k][j][i], inside(k, j, i) ? 2 * src[k][j][i] : -1.0);
+      }
+    }
+  }
+  ASSERT_EQ(visited.size(), (end[0] - start[0]) * (end[1] - start[1]) * (end[2] - start[2]));
+  std::array<size_t, 3> tile_size{ 2, 2, vec_size + 1 };
+  auto tile_of = [&](const std::array<size_t, 3>& p)
+    {
+      std::array<size_t, 3> result;
+      for (int dim = 0; dim < 3; ++dim)
+      {
+        result[dim] = (p[dim] - start[dim]) / tile_size[dim];
+      }
+      return result;
+    };
+  EXPECT_TRUE(std::is_sorted(visited.begin(), visited.end(),
+    [&](const auto& p, const auto& q) { return tile_of(p) < tile_of(q) || (tile_of(p) == tile_of(q) && p < q); }));
+
+  // flat arrays of structures, masked residuals
+  std::vector<TestStruct> flat(nk * nj * ni, TestStruct{ -1.0, { -1.0 } });
+  auto grid = simd_access::make_row_major_view(flat.data(), nk, nj, ni);
+  auto src_grid = simd_access::make_row_major_view(&src[0][0][0], nk, nj, ni);
+  simd_access::loop_nd<vec_size>(start, end, [&](auto idx)
+    {
+      static_assert(!std::is_integral_v<decltype(idx.inner_)>);
+      SIMD_ACCESS(grid, idx, .y[0]) = SIMD_ACCESS_V(src_grid, idx) + 1;
+    }, simd_access::MaskedResidualLoop);
+  for (size_t k = 0; k < nk; ++k)
+  {
+    for (size_t j = 0; j < nj; ++j)
+    {
+      for (size_t i = 0; i < ni; ++i)
+      {
+        const auto& element = flat[(k * nj + j) * ni + i];
+        EXPECT_EQ(element.x, -1.0);
+        EXPECT_EQ(element.y[0], inside(k, j, i) ? src[k][j][i] + 1 : -1.0);
+      }
+    }
+  }
+}
+
+TEST(Loop, Reduce)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (size_t size : { size_t(0), size_t(1), vec_size + 1, 5 * vec_size + 3, size_t(TestData::size) })
+  {
+    std::vector<double> v(size);
+    std::iota(v.begin(), v.end(), 1.0);
+    std::shuffle(v.begin(), v.end(), std::mt19937(1));
+    double sum = size * (size + 1) / 2;
+
+    double plain_sum = simd_access::loop_reduce<vec_size>(0, size, 0.5, [&](auto i)
+      {
+        return SIMD_ACCESS(v, i);
+      }, std::plus<>());
+    EXPECT_EQ(plain_sum, sum + 0.5);
+    double masked_sum = simd_access::loop_reduce<vec_size, 4>(0, size, 0.0, [&](auto i)
+      {
+        return SIMD_ACCESS_V(v, i) * 2;
+      }, std::plus<>(), simd_access::MaskedResidualLoop);
+    EXPECT_EQ(masked_sum, 2 * sum);
+    double min = simd_access::loop_reduce<vec_size, 3>(0, size, 1000.0, [&](auto i)
+      {
+        return SIMD_ACCESS_V(v, i);
+      }, simd_access::minimum(), simd_access::MaskedResidualLoop);
+    EXPECT_EQ(min, size == 0 ? 1000.0 : 1.0);
+
+    // structure-of-simd results via simd_members
+    auto [total, max] = simd_access::loop_reduce<vec_size, 2>(0, size, std::pair(0.0, 0.0), [&](auto i)
+      {
+        return std::pair(SIMD_ACCESS_V(v, i), SIMD_ACCESS_V(v, i));
+      }, [](const auto& x, const auto& y)
+      {
+        return std::pair(x.first + y.first, simd_access::maximum()(x.second, y.second));
+      });
+    EXPECT_EQ(total, sum);
+    EXPECT_EQ(max, size);
+  }
+}
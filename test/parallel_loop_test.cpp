@@ -0,0 +1,205 @@
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/parallel_loop.hpp"
+
+TEST(ParallelLoop, LinearCopy)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (size_t size : { size_t(0), size_t(1), 2 * vec_size + 1, size_t(10001) })
+  {
+    std::vector<double> src(size), dest(size, -1.0);
+    std::iota(src.begin(), src.end(), 0.0);
+    std::atomic<size_t> scalar_calls = 0;
+
+    simd_access::parallel_loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS(src, i) * 2;
+        if constexpr (std::is_integral_v<decltype(i)>)
+        {
+          ++scalar_calls;
+        }
+      });
+    // only the end of the whole range is executed as residual loop
+    EXPECT_EQ(scalar_calls, size % vec_size);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i * 2);
+    }
+
+    simd_access::parallel_loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        SIMD_ACCESS(dest, i) = SIMD_ACCESS(src, i) + 1;
+      }, simd_access::MaskedResidualLoop, 3);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i + 1);
+    }
+  }
+}
+
+TEST(ParallelLoop, IndirectCopy)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr size_t size = 1003;
+  std::vector<double> src(size), dest(size, -1.0);
+  std::vector<int> indices(size);
+  std::iota(src.begin(), src.end(), 0.0);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::mt19937 g(1);
+  std::shuffle(indices.begin(), indices.end(), g);
+
+  simd_access::parallel_loop<vec_size>(indices.begin(), indices.end(), [&](auto i)
+    {
+      SIMD_ACCESS(dest, i) = SIMD_ACCESS(src, i) * 3;
+    }, simd_access::ScalarResidualLoop, 16);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(dest[i], i * 3);
+  }
+}
+
+TEST(ParallelLoop, ThreadPool)
+{
+  simd_access::thread_pool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+
+  std::vector<int> counts(1000, 0);
+  pool.run(counts.size(), [&](size_t task)
+    {
+      // nested calls are executed by the calling thread
+      pool.run(2, [&](size_t) { ++counts[task]; });
+    });
+  EXPECT_TRUE(std::all_of(counts.begin(), counts.end(), [](int c) { return c == 2; }));
+
+  EXPECT_THROW(pool.run(100, [](size_t task)
+    {
+      if (task == 50)
+      {
+        throw std::runtime_error("task failed");
+      }
+    }), std::runtime_error);
+
+  // the pool is still usable after an exception
+  std::atomic<size_t> sum = 0;
+  pool.run(100, [&](size_t task) { sum += task; });
+  EXPECT_EQ(sum, 4950);
+}
+
+TEST(ParallelLoop, IndirectCopyWithLinearIndex)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  constexpr size_t size = 1003;
+  std::vector<double> src(size), dest(size, -1.0);
+  std::vector<int> indices(size);
+  std::iota(src.begin(), src.end(), 0.0);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::mt19937 g(2);
+  std::shuffle(indices.begin(), indices.end(), g);
+
+  simd_access::thread_pool pool(3);
+  simd_access::parallel_loop_with_linear_index<vec_size>(pool, indices.begin(), indices.end(), [&](auto i, auto j)
+    {
+      SIMD_ACCESS(dest, i) = SIMD_ACCESS_V(src, j);
+    }, simd_access::MaskedResidualLoop, 8);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(dest[i], indices[i]);
+  }
+}
+
+TEST(ParallelLoop, WorkStealing)
+{
+  simd_access::thread_pool pool(4);
+  std::vector<std::atomic<int>> counts(997);
+  std::vector<double> results(counts.size());
+  pool.run(counts.size(), [&](size_t task)
+    {
+      // the tasks of the first thread are much more expensive than the others
+      double x = 0;
+      for (size_t k = 0, e = task < counts.size() / 4 ? 20000 : 10; k < e; ++k)
+      {
+        x += std::sqrt(double(k + task));
+      }
+      results[task] = x;
+      ++counts[task];
+    });
+  EXPECT_TRUE(std::all_of(counts.begin(), counts.end(), [](const auto& c) { return c == 1; }));
+  EXPECT_GT(results.back(), 0);
+
+  // task 0 blocks its thread until all other tasks are done, thus the other tasks of its queue must be stolen by
+  // other threads
+  constexpr size_t task_count = 16;
+  std::vector<std::thread::id> executors(task_count);
+  std::atomic<size_t> done = 0;
+  bool all_done = false;
+  pool.run(task_count, [&](size_t task)
+    {
+      executors[task] = std::this_thread::get_id();
+      if (task == 0)
+      {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (done < task_count - 1 && std::chrono::steady_clock::now() < deadline)
+        {
+          std::this_thread::yield();
+        }
+        all_done = done == task_count - 1;
+      }
+      ++done;
+    });
+  EXPECT_TRUE(all_done);
+  // the queue of the calling thread initially holds the tasks [0, task_count / pool.size()), some of them were stolen
+  const auto caller = std::this_thread::get_id();
+  EXPECT_TRUE(std::any_of(executors.begin(), executors.begin() + task_count / pool.size(),
+    [&](const auto& executor) { return executor != caller; }));
+}
+
+TEST(ParallelLoop, Reduce)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  simd_access::thread_pool pool(4);
+  for (size_t size : { size_t(0), size_t(1), 2 * vec_size + 1, size_t(10001) })
+  {
+    std::vector<double> v(size);
+    std::iota(v.begin(), v.end(), 1.0);
+    double sum = size * (size + 1) / 2;
+
+    double total = simd_access::parallel_loop_reduce<vec_size>(pool, size_t(0), size, 0.0, [&](auto i)
+      {
+        return SIMD_ACCESS(v, i);
+      }, std::plus<>());
+    EXPECT_EQ(total, sum);
+    double max = simd_access::parallel_loop_reduce<vec_size, 4>(size_t(0), size, -1.0, [&](auto i)
+      {
+        return SIMD_ACCESS_V(v, i);
+      }, simd_access::maximum(), simd_access::MaskedResidualLoop, 3);
+    EXPECT_EQ(max, size == 0 ? -1.0 : size);
+
+    // the partial results are combined in a fixed order
+    std::vector<double> fractions(size);
+    std::mt19937 g(1);
+    std::generate(fractions.begin(), fractions.end(), [&]() { return std::generate_canonical<double, 53>(g); });
+    auto reduce = [&]()
+      {
+        return simd_access::parallel_loop_reduce<vec_size>(pool, size_t(0), size, 0.0, [&](auto i)
+          {
+            return SIMD_ACCESS(fractions, i);
+          }, std::plus<>(), simd_access::ScalarResidualLoop, 64);
+      };
+    double first = reduce();
+    for (int i = 0; i < 10; ++i)
+    {
+      EXPECT_EQ(reduce(), first);
+    }
+  }
+}
@@ -0,0 +1,56 @@
+// See the file "LICENSE" for the full license governing this code.
+
+/**
+ * @file
+ * @brief Particle structure shared by the tests of the containers in structure-of-arrays layout.
+ */
+
+#ifndef SIMD_ACCESS_TEST_PARTICLE
+#define SIMD_ACCESS_TEST_PARTICLE
+
+#include "simd_access/simd_access.hpp"
+
+template<class T>
+struct Particle
+{
+  T x;
+  T v[2];
+};
+
+template<int SimdSize, class T>
+inline auto simdized_value(const Particle<T>& p)
+{
+  using simd_access::simdized_value;
+  return Particle<decltype(simdized_value<SimdSize>(p.x))>();
+}
+
+template<class DestType, class SrcType, class FN>
+inline void simd_members(Particle<DestType>& d, const Particle<SrcType>& s, FN&& func)
+{
+  using simd_access::simd_members;
+  simd_members(d.x, s.x, func);
+  simd_members(d.v[0], s.v[0], func);
+  simd_members(d.v[1], s.v[1], func);
+}
+
+template<class Container>
+inline void fill(Container& particles)
+{
+  for (int i = 0; i < particles.size(); ++i)
+  {
+    particles[i] = Particle<double>{ double(i), { i + 1000.0, i + 2000.0 } };
+  }
+}
+
+// The same code runs on a vector of structures and on vectors in structure-of-arrays layout.
+template<int SimdSize, class Container>
+inline void move(Container& particles, double dt)
+{
+  simd_access::loop<SimdSize>(0, particles.size(), [&](auto i)
+    {
+      SIMD_ACCESS(particles, i, .x) += dt * SIMD_ACCESS_V(particles, i, .v[0]);
+      SIMD_ACCESS(particles, i, .v[1]) = SIMD_ACCESS_V(particles, i, .v[1]) * 2;
+    });
+}
+
+#endif //SIMD_ACCESS_TEST_PARTICLE
@@ -0,0 +1,103 @@
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/quantized_view.hpp"
+
+namespace {
+
+template<class StoredType, class ResidualLoopPolicyType>
+void test_dequantize(size_t size, ResidualLoopPolicyType residualLoopPolicy)
+{
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  std::vector<StoredType> stored(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    stored[i] = StoredType(int(i * 37) % 256 + int(std::numeric_limits<StoredType>::lowest()));
+  }
+  // exactly sized arrays, so that out-of-bounds accesses are detected by sanitizers
+  std::vector<float> result(size);
+  auto view = simd_access::make_quantized_view(stored.data(), stored.size(), 0.25f, -3.0f);
+  simd_access::loop<vec_size>(0, size, [&](auto i)
+    {
+      SIMD_ACCESS(result, i) = SIMD_ACCESS_V(view, i) * 2.0f;
+    }, residualLoopPolicy);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(result[i], (0.25f * float(stored[i]) - 3.0f) * 2.0f) << "size " << size << ", i " << i;
+  }
+}
+
+}
+
+
+TEST(QuantizedView, Dequantize)
+{
+  for (size_t size : { 1, 7, 8, 33, 103 })
+  {
+    test_dequantize<std::int8_t>(size, simd_access::ScalarResidualLoop);
+    test_dequantize<std::uint8_t>(size, simd_access::MaskedResidualLoop);
+    test_dequantize<std::int16_t>(size, simd_access::MaskedResidualLoop);
+  }
+
+  // lookup table accessed by indirect indices
+  constexpr int vec_size = 8;
+  std::vector<std::uint16_t> table(1000);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    table[i] = std::uint16_t(i * 61);
+  }
+  const auto lut = simd_access::make_quantized_view<double>(table.data(), table.size(), 0.5, 100.0);
+  const int indices[vec_size] = { 999, 0, 17, 17, 500, 3, 64, 128 };
+  simd_access::index_array<vec_size, const int*> indirect{indices};
+  auto x = SIMD_ACCESS_V(lut, indirect);
+  static_assert(std::is_same_v<decltype(x), stdx::fixed_size_simd<double, vec_size>>);
+  for (int i = 0; i < vec_size; ++i)
+  {
+    EXPECT_EQ(x[i], 0.5 * double(table[indices[i]]) + 100.0);
+    EXPECT_EQ(double(lut[indices[i]]), x[i]);
+  }
+}
+
+TEST(QuantizedView, Quantize)
+{
+  constexpr int vec_size = 8;
+  std::vector<std::int8_t> stored(vec_size + 3);
+  auto view = simd_access::make_quantized_view(stored.data(), stored.size(), 0.5f, 1.0f);
+  // rounding to nearest even, saturation and NaN
+  const float values[vec_size + 3] = { 1.0f, 1.24f, 1.26f, 1.25f, 1.75f, 1000.0f, -1000.0f, std::nanf(""), -62.5f,
+    64.5f, 0.0f };
+  const std::int8_t expected[vec_size + 3] = { 0, 0, 1, 0, 2, 127, -128, 0, -127, 127, -2 };
+  simd_access::loop<vec_size>(0, stored.size(), [&](auto i)
+    {
+      SIMD_ACCESS(view, i) = SIMD_ACCESS_V(values, i);
+    });
+  for (size_t i = 0; i < stored.size(); ++i)
+  {
+    EXPECT_EQ(stored[i], expected[i]) << "i " << i;
+  }
+
+  // compound assignments and masked stores
+  simd_access::index<vec_size> index{0};
+  SIMD_ACCESS(view, index) += 1.0f;
+  auto x = SIMD_ACCESS_V(view, index);
+  where(x > 50.0f, SIMD_ACCESS(view, index)) = 0.0f;
+  view[vec_size] -= 10.0f;
+  for (int i = 0; i < vec_size; ++i)
+  {
+    std::int8_t incremented = std::int8_t(std::min(expected[i] + 2, 127));
+    EXPECT_EQ(stored[i], 0.5f * incremented + 1.0f > 50.0f ? -2 : incremented) << "i " << i;
+  }
+  EXPECT_EQ(stored[vec_size], -128);
+
+  // the quantization as encoding of an arbitrary access
+  std::vector<std::int16_t> raw{ 10, 20, 30, 40 };
+  simd_access::linear_quantization<double> quantization{0.125, 0.0};
+  simd_access::index<4> i4{0};
+  simd_access::as<double>(SIMD_ACCESS(raw, i4), quantization) *= 2.0;
+  EXPECT_EQ(raw, (std::vector<std::int16_t>{ 20, 40, 60, 80 }));
+}
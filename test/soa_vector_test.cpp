@@ -0,0 +1,90 @@
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/soa_vector.hpp"
+#include "particle.hpp"
+
+
+TEST(SoaVector, ScalarAccess)
+{
+  simd_access::soa_vector<Particle<double>> particles(10);
+  EXPECT_EQ(particles.size(), 10);
+  fill(particles);
+  particles.push_back(Particle<double>{ 10.0, { 1010.0, 2010.0 } });
+  EXPECT_EQ(particles.size(), 11);
+
+  const auto& cparticles = particles;
+  for (int i = 0; i < particles.size(); ++i)
+  {
+    Particle<double> p = cparticles[i];
+    EXPECT_EQ(p.x, i);
+    EXPECT_EQ(p.v[0], i + 1000);
+    EXPECT_EQ(SIMD_ACCESS(cparticles, i, .v[1]), i + 2000);
+  }
+  // the members are stored in separate arrays
+  EXPECT_EQ(&SIMD_ACCESS(particles, 4, .v[0]), &SIMD_ACCESS(particles, 3, .v[0]) + 1);
+
+  SIMD_ACCESS(particles, 2, .v[1]) = -1;
+  particles[3] = particles[2];
+  EXPECT_EQ(SIMD_ACCESS(particles, 3, .x), 2);
+  EXPECT_EQ(SIMD_ACCESS(particles, 3, .v[1]), -1);
+
+  particles.clear();
+  EXPECT_TRUE(particles.empty());
+}
+
+TEST(SoaVector, MemberAccess)
+{
+  static constexpr size_t size = 103;
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  std::vector<Particle<double>> aos(size);
+  simd_access::soa_vector<Particle<double>> soa(size);
+  fill(aos);
+  fill(soa);
+
+  move<vec_size>(aos, 0.5);
+  move<vec_size>(soa, 0.5);
+
+  for (int i = 0; i < size; ++i)
+  {
+    Particle<double> p = soa[i];
+    EXPECT_EQ(p.x, aos[i].x);
+    EXPECT_EQ(p.v[0], aos[i].v[0]);
+    EXPECT_EQ(p.v[1], aos[i].v[1]);
+  }
+}
+
+TEST(SoaVector, StructureAccess)
+{
+  static constexpr size_t size = 103;
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  simd_access::soa_vector<Particle<double>> src(size), dest(size), indirect_dest(size);
+  fill(src);
+  std::vector<int> reversed(size);
+  for (int i = 0; i < size; ++i)
+  {
+    reversed[i] = size - 1 - i;
+  }
+
+  simd_access::loop<vec_size>(0, size, [&](auto i)
+    {
+      auto p = SIMD_ACCESS_V(src, i);
+      p.x = p.x + p.v[1];
+      SIMD_ACCESS(dest, i) = p;
+    }, simd_access::MaskedResidualLoop);
+  simd_access::loop_with_linear_index<vec_size>(reversed.cbegin(), reversed.cend(), [&](auto linear_i, auto i)
+    {
+      SIMD_ACCESS(indirect_dest, i) = SIMD_ACCESS_V(src, linear_i);
+    }, simd_access::MaskedResidualLoop);
+
+  for (int i = 0; i < size; ++i)
+  {
+    Particle<double> p = dest[i], q = indirect_dest[size - 1 - i];
+    EXPECT_EQ(p.x, 2 * i + 2000);
+    EXPECT_EQ(p.v[0], i + 1000);
+    EXPECT_EQ(q.x, i);
+    EXPECT_EQ(q.v[1], i + 2000);
+  }
+}
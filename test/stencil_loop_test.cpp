@@ -0,0 +1,87 @@
+
+#include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
+
+#include "simd_access/simd_access.hpp"
+#include "simd_access/stencil_loop.hpp"
+
+namespace {
+
+// 5-point smoother as reference
+double smooth5(const std::vector<double>& u, size_t i)
+{
+  return (u[i - 2] + 4 * u[i - 1] + 6 * u[i] + 4 * u[i + 1] + u[i + 2]) / 16;
+}
+
+template<class ResidualLoopPolicyType>
+void test_smoother(size_t size, ResidualLoopPolicyType residualLoopPolicy)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  // exactly sized arrays, so that out-of-bounds accesses are detected by sanitizers
+  std::vector<double> u(size), result(size, -1.0), expected(size, -1.0);
+  for (size_t i = 0; i < size; ++i)
+  {
+    u[i] = double(i * i % 17);
+  }
+  for (size_t i = 2; i + 2 < size; ++i)
+  {
+    expected[i] = smooth5(u, i);
+  }
+
+  simd_access::stencil_loop<vec_size, 2>(size_t(2), size - 2, u, [&](auto i, const auto& u_i)
+    {
+      SIMD_ACCESS(result, i) = (u_i[-2] + 4 * u_i[-1] + 6 * u_i[0] + 4 * u_i[1] + u_i[2]) / 16;
+    }, residualLoopPolicy);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(result[i], expected[i]) << "size " << size << ", i " << i;
+  }
+
+  // the same stencil written with shifted indices
+  std::fill(result.begin(), result.end(), -1.0);
+  simd_access::loop<vec_size>(size_t(2), size - 2, [&](auto i)
+    {
+      SIMD_ACCESS(result, i) = (SIMD_ACCESS_V(u, i - 2) + 4 * SIMD_ACCESS_V(u, i - 1) + 6 * SIMD_ACCESS_V(u, i) +
+        4 * SIMD_ACCESS_V(u, i + 1) + SIMD_ACCESS_V(u, i + 2)) / 16;
+    }, residualLoopPolicy);
+  for (size_t i = 0; i < size; ++i)
+  {
+    EXPECT_EQ(result[i], expected[i]) << "size " << size << ", i " << i;
+  }
+}
+
+}
+
+
+TEST(StencilLoop, Smoother)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (size_t size : { size_t(4), size_t(5), vec_size + 4, 2 * vec_size + 3, 3 * vec_size + 4, size_t(103) })
+  {
+    test_smoother(size, simd_access::ScalarResidualLoop);
+    test_smoother(size, simd_access::MaskedResidualLoop);
+  }
+}
+
+TEST(StencilLoop, Radius)
+{
+  constexpr size_t vec_size = stdx::native_simd<float>::size();
+  constexpr int radius = int(vec_size);
+  constexpr size_t size = 10 * vec_size + 1;
+  std::vector<float> u(size), result(size, 0.0f);
+  std::iota(u.begin(), u.end(), 0.0f);
+
+  int calls = 0;
+  // the neighbours of a radius larger than half the vector size are loaded separately
+  simd_access::stencil_loop<vec_size, radius>(radius, size - radius, u, [&](auto i, const auto& u_i)
+    {
+      SIMD_ACCESS(result, i) = u_i[radius] - u_i[-radius] + u_i[1];
+      ++calls;
+    });
+  EXPECT_EQ(calls, (size - 2 * radius) / vec_size + (size - 2 * radius) % vec_size);
+  for (size_t i = radius; i + radius < size; ++i)
+  {
+    EXPECT_EQ(result[i], 2 * radius + i + 1);
+  }
+}
@@ -1,5 +1,6 @@
 
 #include <gtest/gtest.h>
+#include <cstdint>
 
 #include "simd_access/simd_access.hpp"
 #include "simd_access/vector.hpp"
@@ -28,3 +29,47 @@ TEST(VectorTest, ArrayAdd)
     EXPECT_EQ(dest[i], i * 3);
   }
 }
+
+TEST(VectorTest, AlignedVector)
+{
+  constexpr size_t vec_size = stdx::native_simd<double>::size();
+  for (size_t size : { size_t(1), vec_size + 1, size_t(103) })
+  {
+    simd_access::aligned_vector<double> src(size), dest(size, -1.0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(src.data()) % 64, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(dest.data()) % 64, 0);
+    for (size_t i = 0; i < size; ++i)
+    {
+      src[i] = i;
+    }
+
+    int scalar_calls = 0;
+    simd_access::loop<vec_size>(size_t(0), size, [&](auto i)
+      {
+        if constexpr (std::is_integral_v<decltype(i)>)
+        {
+          ++scalar_calls;
+        }
+        dest[i] = src[i] * 2;
+      }, simd_access::VectorResidualLoop, simd_access::aligned_access(dest));
+    EXPECT_EQ(scalar_calls, 0);
+    for (size_t i = 0; i < size; ++i)
+    {
+      EXPECT_EQ(dest[i], i * 2);
+    }
+
+    // without peeling the vectorized iterations starting at 1 aren't aligned, thus no aligned accesses are used
+    const size_t end = 1 + (size - 1) / vec_size * vec_size;
+    int aligned_calls = 0;
+    simd_access::loop<vec_size>(size_t(1), end, [&](auto i)
+      {
+        aligned_calls += std::is_same_v<decltype(i), simd_access::aligned_index<vec_size, size_t>>;
+        dest[i] = src[i] + 1;
+      }, simd_access::VectorResidualLoop, simd_access::aligned_access(dest));
+    EXPECT_EQ(aligned_calls, 0);
+    for (size_t i = 1; i < end; ++i)
+    {
+      EXPECT_EQ(dest[i], i + 1);
+    }
+  }
+}